@@ -1,5 +1,20 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+#include "runtime.hpp"
+
+#ifdef AU_X86_KERNELS
+#include <immintrin.h>
+#endif
 
 template <typename T>
 void auSwap(T &a, T &b)
@@ -32,18 +47,337 @@ void auReverse(BidirectionalIter beg, BidirectionalIter end)
     }
 }
 
-template <typename ForwardIter, typename Key>
-ForwardIter auFind(ForwardIter beg, ForwardIter end, const Key &key)
+namespace au_detail
 {
-    for (; beg != end; ++beg)
+    // Ranges whose elements sit in one array and may be read as plain
+    // memory: raw pointers and vector iterators.
+    template <typename Iter, typename V = typename std::iterator_traits<Iter>::value_type>
+    struct IsContiguous
+        : std::integral_constant<bool, std::is_pointer<Iter>::value ||
+                                           std::is_same<Iter, typename std::vector<V>::iterator>::value ||
+                                           std::is_same<Iter, typename std::vector<V>::const_iterator>::value>
+    {
+    };
+
+    template <typename Iter, typename V = typename std::iterator_traits<Iter>::value_type>
+    struct IsContiguousIntegral
+        : std::integral_constant<bool, IsContiguous<Iter>::value && std::is_integral<V>::value &&
+                                           !std::is_same<V, bool>::value>
+    {
+    };
+
+    inline unsigned lowestBit(unsigned mask)
     {
-        if (*beg == key)
+#if defined(__GNUC__)
+        return unsigned(__builtin_ctz(mask));
+#else
+        unsigned i = 0;
+        for (; !(mask & 1); mask >>= 1)
         {
-            return beg;
+            i++;
         }
+        return i;
+#endif
     }
 
-    return beg;
+    template <typename T>
+    std::size_t findScalar(const T *p, std::size_t n, T key)
+    {
+        std::size_t i = 0;
+        while (i < n && !(p[i] == key))
+        {
+            i++;
+        }
+        return i;
+    }
+
+    template <typename T>
+    T minScalar(const T *p, std::size_t n)
+    {
+        T m = p[0];
+        for (std::size_t i = 1; i < n; i++)
+        {
+            m = p[i] < m ? p[i] : m;
+        }
+        return m;
+    }
+
+#ifdef AU_X86_KERNELS
+    // Index of the first element equal to key, or n. Four vectors are
+    // compared per step and only tested for a hit as a whole.
+    template <typename T>
+    __attribute__((target("avx2"))) std::size_t findAvx2(const T *p, std::size_t n, T key)
+    {
+        const __m256i k = sizeof(T) == 1   ? _mm256_set1_epi8(char(key))
+                          : sizeof(T) == 2 ? _mm256_set1_epi16(short(key))
+                          : sizeof(T) == 4 ? _mm256_set1_epi32(int(key))
+                                           : _mm256_set1_epi64x((long long)key);
+        const std::size_t step = 32 / sizeof(T);
+        std::size_t i = 0;
+
+        for (; i + 4 * step <= n; i += 4 * step)
+        {
+            __m256i e[4];
+            for (int j = 0; j < 4; j++)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i + j * step));
+                e[j] = sizeof(T) == 1   ? _mm256_cmpeq_epi8(v, k)
+                       : sizeof(T) == 2 ? _mm256_cmpeq_epi16(v, k)
+                       : sizeof(T) == 4 ? _mm256_cmpeq_epi32(v, k)
+                                        : _mm256_cmpeq_epi64(v, k);
+            }
+
+            __m256i any = _mm256_or_si256(_mm256_or_si256(e[0], e[1]), _mm256_or_si256(e[2], e[3]));
+            if (!_mm256_testz_si256(any, any))
+            {
+                for (int j = 0;; j++)
+                {
+                    unsigned mask = unsigned(_mm256_movemask_epi8(e[j]));
+                    if (mask != 0)
+                    {
+                        return i + j * step + lowestBit(mask) / sizeof(T);
+                    }
+                }
+            }
+        }
+
+        return i + findScalar(p + i, n - i, key);
+    }
+
+    template <typename T>
+    __attribute__((target("avx2"))) T minAvx2(const T *p, std::size_t n)
+    {
+        const bool isSigned = std::is_signed<T>::value;
+        std::size_t i = 0;
+        T m = p[0];
+
+        if (n >= 8)
+        {
+            __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            for (i = 8; i + 8 <= n; i += 8)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                acc = isSigned ? _mm256_min_epi32(acc, v) : _mm256_min_epu32(acc, v);
+            }
+
+            T lanes[8];
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc);
+            m = minScalar(lanes, 8);
+        }
+
+        for (; i < n; i++)
+        {
+            m = p[i] < m ? p[i] : m;
+        }
+        return m;
+    }
+#endif
+
+#if defined(AU_X86_KERNELS) && defined(__SSE2__)
+    // Baseline x86-64 versions; SSE2 has no 64-bit equality or 32-bit
+    // minimum, so those go through the scalar loop and a compare-and-
+    // select respectively.
+    template <typename T>
+    std::size_t findSse2(const T *p, std::size_t n, T key)
+    {
+        if (sizeof(T) == 8)
+        {
+            return findScalar(p, n, key);
+        }
+
+        const __m128i k = sizeof(T) == 1   ? _mm_set1_epi8(char(key))
+                          : sizeof(T) == 2 ? _mm_set1_epi16(short(key))
+                                           : _mm_set1_epi32(int(key));
+        const std::size_t step = 16 / sizeof(T);
+        std::size_t i = 0;
+
+        for (; i + 4 * step <= n; i += 4 * step)
+        {
+            __m128i e[4];
+            for (int j = 0; j < 4; j++)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i + j * step));
+                e[j] = sizeof(T) == 1   ? _mm_cmpeq_epi8(v, k)
+                       : sizeof(T) == 2 ? _mm_cmpeq_epi16(v, k)
+                                        : _mm_cmpeq_epi32(v, k);
+            }
+
+            __m128i any = _mm_or_si128(_mm_or_si128(e[0], e[1]), _mm_or_si128(e[2], e[3]));
+            if (_mm_movemask_epi8(any) != 0)
+            {
+                for (int j = 0;; j++)
+                {
+                    unsigned mask = unsigned(_mm_movemask_epi8(e[j]));
+                    if (mask != 0)
+                    {
+                        return i + j * step + lowestBit(mask) / sizeof(T);
+                    }
+                }
+            }
+        }
+
+        return i + findScalar(p + i, n - i, key);
+    }
+
+    template <typename T>
+    T minSse2(const T *p, std::size_t n)
+    {
+        // unsigned values are compared as signed after flipping the top bit
+        const __m128i flip = _mm_set1_epi32(std::is_signed<T>::value ? 0 : int(0x80000000u));
+        std::size_t i = 0;
+        T m = p[0];
+
+        if (n >= 4)
+        {
+            __m128i acc = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), flip);
+            for (i = 4; i + 4 <= n; i += 4)
+            {
+                __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i)), flip);
+                __m128i less = _mm_cmplt_epi32(v, acc);
+                acc = _mm_or_si128(_mm_and_si128(less, v), _mm_andnot_si128(less, acc));
+            }
+
+            T lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(acc, flip));
+            m = minScalar(lanes, 4);
+        }
+
+        for (; i < n; i++)
+        {
+            m = p[i] < m ? p[i] : m;
+        }
+        return m;
+    }
+#endif
+
+    template <typename T>
+    std::size_t findKernel(const T *p, std::size_t n, T key)
+    {
+#ifdef AU_X86_KERNELS
+        if (n >= 64 && hasAvx2())
+        {
+            return findAvx2(p, n, key);
+        }
+#endif
+#if defined(AU_X86_KERNELS) && defined(__SSE2__)
+        return findSse2(p, n, key);
+#else
+        return findScalar(p, n, key);
+#endif
+    }
+
+    // Minimum of p[0, n), n > 0; vectorized for 32-bit integers.
+    template <typename T>
+    T minKernel(const T *p, std::size_t n, std::false_type)
+    {
+        return minScalar(p, n);
+    }
+
+    template <typename T>
+    T minKernel(const T *p, std::size_t n, std::true_type)
+    {
+#ifdef AU_X86_KERNELS
+        if (n >= 64 && hasAvx2())
+        {
+            return minAvx2(p, n);
+        }
+#endif
+#if defined(AU_X86_KERNELS) && defined(__SSE2__)
+        return minSse2(p, n);
+#else
+        return minScalar(p, n);
+#endif
+    }
+
+    template <typename T>
+    T minKernel(const T *p, std::size_t n)
+    {
+        return minKernel(p, n, std::integral_constant<bool, sizeof(T) == 4>());
+    }
+
+    template <typename Iter, typename Key>
+    Iter find(Iter beg, Iter end, const Key &key, std::false_type)
+    {
+        for (; beg != end; ++beg)
+        {
+            if (*beg == key)
+            {
+                return beg;
+            }
+        }
+
+        return beg;
+    }
+
+    template <typename Iter, typename Key>
+    Iter find(Iter beg, Iter end, const Key &key, std::true_type)
+    {
+        std::size_t n = std::size_t(end - beg);
+        return n == 0 ? beg : beg + findKernel(&*beg, n, key);
+    }
+
+    template <typename Iter>
+    Iter minElement(Iter beg, Iter end, std::false_type)
+    {
+        if (beg == end)
+            return end;
+
+        Iter min = beg++;
+
+        for (; beg != end; ++beg)
+        {
+            if (*beg < *min)
+            {
+                min = beg;
+            }
+        }
+
+        return min;
+    }
+
+    // Takes the minimum of each chunk with the vector kernel, remembering
+    // the first chunk holding the smallest one, then finds its first
+    // occurrence within that chunk.
+    template <typename Iter>
+    Iter minElement(Iter beg, Iter end, std::true_type)
+    {
+        typedef typename std::iterator_traits<Iter>::value_type T;
+        const std::size_t CHUNK = 4096;
+        std::size_t n = std::size_t(end - beg);
+
+        if (n == 0)
+        {
+            return end;
+        }
+
+        const T *p = &*beg;
+        T best = p[0];
+        std::size_t bestChunk = 0;
+
+        for (std::size_t c = 0; c < n; c += CHUNK)
+        {
+            T m = minKernel(p + c, n - c < CHUNK ? n - c : CHUNK);
+            if (m < best)
+            {
+                best = m;
+                bestChunk = c;
+            }
+        }
+
+        std::size_t length = n - bestChunk < CHUNK ? n - bestChunk : CHUNK;
+        return beg + (bestChunk + findKernel(p + bestChunk, length, best));
+    }
+}
+
+template <typename ForwardIter, typename Key>
+ForwardIter auFind(ForwardIter beg, ForwardIter end, const Key &key)
+{
+    typedef typename std::iterator_traits<ForwardIter>::value_type Value;
+    typedef std::integral_constant<bool, au_detail::IsContiguousIntegral<ForwardIter>::value &&
+                                             std::is_same<Key, Value>::value>
+        Vectorized;
+
+    return au_detail::find(beg, end, key, Vectorized());
 }
 
 template <typename ForwardIter, typename UnaryPredicate>
@@ -62,6 +396,12 @@ ForwardIter auFindIf(ForwardIter beg, ForwardIter end, UnaryPredicate pred)
 
 template <typename ForwardIter>
 ForwardIter auMinElement(ForwardIter beg, ForwardIter end)
+{
+    return au_detail::minElement(beg, end, au_detail::IsContiguousIntegral<ForwardIter>());
+}
+
+template <typename ForwardIter, typename Predicate>
+ForwardIter auMinElement(ForwardIter beg, ForwardIter end, Predicate pred)
 {
     if (beg == end)
         return end;
@@ -70,7 +410,7 @@ ForwardIter auMinElement(ForwardIter beg, ForwardIter end)
 
     for (; beg != end; ++beg)
     {
-        if (*beg < *min)
+        if (pred(*beg, *min))
         {
             min = beg;
         }
@@ -79,42 +419,364 @@ ForwardIter auMinElement(ForwardIter beg, ForwardIter end)
     return min;
 }
 
-template <typename ForwardIter, typename Predicate>
-ForwardIter auMinElement(ForwardIter beg, ForwardIter end, Predicate pred)
+// Asks an au algorithm to split its range into threads parts, 0 meaning
+// the hardware concurrency. Only random-access ranges are split, and only
+// into parts of at least AuParallel::GRAIN elements (GRAIN swaps for
+// auReverse), so shorter ranges and other iterators run sequentially.
+// The first part runs on the calling thread and the others are queued on
+// one pool of hardware concurrency - 1 threads, created on first use and
+// shared by all calls. threads therefore sets the number of parts, not
+// the parallelism: asking for more than the hardware concurrency only
+// makes the parts smaller.
+struct AuParallel
 {
-    if (beg == end)
-        return end;
+    static const std::size_t GRAIN = std::size_t(1) << 16;
 
-    ForwardIter min = beg++;
+    unsigned threads;
 
-    for (; beg != end; ++beg)
+    explicit AuParallel(unsigned count = 0) : threads(count)
     {
-        if (pred(*beg, *min))
+    }
+};
+
+namespace au_detail
+{
+    inline unsigned partCount(const AuParallel &policy, std::size_t n)
+    {
+        unsigned t = policy.threads != 0 ? policy.threads : std::thread::hardware_concurrency();
+        std::size_t most = n / AuParallel::GRAIN;
+
+        if (t == 0 || most == 0)
         {
-            min = beg;
+            return 1;
         }
+        return most < t ? unsigned(most) : t;
     }
 
-    return min;
+    inline ThreadPool &sharedPool()
+    {
+        static unsigned cores = std::thread::hardware_concurrency();
+        static ThreadPool pool(cores > 1 ? cores - 1 : 0);
+        return pool;
+    }
+
+    // Calls body(i, parts) for every i < parts, part 0 on the calling
+    // thread and the rest on the shared pool, and rethrows the first
+    // exception any of them threw.
+    template <typename Body>
+    void runParts(unsigned parts, Body body)
+    {
+        std::vector<std::exception_ptr> errors(parts);
+
+        auto run = [&](unsigned i)
+        {
+            try
+            {
+                body(i, parts);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        };
+
+        if (parts > 1)
+        {
+            ThreadPool &pool = sharedPool();
+            std::size_t pending = parts - 1;
+
+            for (unsigned i = 1; i < parts; i++)
+            {
+                pool.submit([&run, &pool, &pending, i]
+                            {
+                                run(i);
+                                pool.finish(pending);
+                            });
+            }
+            run(0);
+            pool.wait(pending);
+        }
+        else
+        {
+            run(0);
+        }
+
+        for (auto &e : errors)
+        {
+            if (e)
+            {
+                std::rethrow_exception(e);
+            }
+        }
+    }
+
+    // Bounds of part i of parts over n elements.
+    inline std::size_t partBegin(std::size_t n, unsigned i, unsigned parts)
+    {
+        return std::size_t((unsigned long long)n * i / parts);
+    }
+
+    // Index of the first element for which search(from, to) finds a match,
+    // or n. Every part scans its range a step at a time and gives up once
+    // another part has found a match before the step it is at.
+    template <typename Search>
+    std::size_t parallelSearch(const AuParallel &policy, std::size_t n, Search search)
+    {
+        const std::size_t STEP = std::size_t(1) << 14;
+        std::atomic<std::size_t> found(n);
+
+        runParts(partCount(policy, n), [&](unsigned i, unsigned parts)
+                 {
+                     std::size_t end = partBegin(n, i + 1, parts);
+
+                     for (std::size_t from = partBegin(n, i, parts); from < end; from += STEP)
+                     {
+                         if (found.load(std::memory_order_relaxed) < from)
+                         {
+                             return;
+                         }
+
+                         std::size_t to = end - from < STEP ? end : from + STEP;
+                         std::size_t hit = search(from, to);
+
+                         if (hit != to)
+                         {
+                             std::size_t current = found.load();
+                             while (hit < current && !found.compare_exchange_weak(current, hit))
+                             {
+                             }
+                             return;
+                         }
+                     }
+                 });
+
+        return found.load();
+    }
+
+    template <typename Iter, typename Key>
+    Iter parallelFind(const AuParallel &policy, Iter beg, Iter end, const Key &key, std::random_access_iterator_tag)
+    {
+        return beg + parallelSearch(policy, std::size_t(end - beg), [&](std::size_t from, std::size_t to)
+                                    { return std::size_t(auFind(beg + from, beg + to, key) - beg); });
+    }
+
+    template <typename Iter, typename Key>
+    Iter parallelFind(const AuParallel &, Iter beg, Iter end, const Key &key, std::forward_iterator_tag)
+    {
+        return auFind(beg, end, key);
+    }
+
+    template <typename Iter, typename UnaryPredicate>
+    Iter parallelFindIf(const AuParallel &policy, Iter beg, Iter end, UnaryPredicate pred,
+                        std::random_access_iterator_tag)
+    {
+        return beg + parallelSearch(policy, std::size_t(end - beg), [&](std::size_t from, std::size_t to)
+                                    { return std::size_t(auFindIf(beg + from, beg + to, pred) - beg); });
+    }
+
+    template <typename Iter, typename UnaryPredicate>
+    Iter parallelFindIf(const AuParallel &, Iter beg, Iter end, UnaryPredicate pred, std::forward_iterator_tag)
+    {
+        return auFindIf(beg, end, pred);
+    }
+
+    // Each part finds its own minimum; the parts are in order, so keeping
+    // a later one only when strictly smaller yields the first minimum.
+    template <typename Iter, typename Predicate>
+    Iter parallelMinElement(const AuParallel &policy, Iter beg, Iter end, Predicate pred,
+                            std::random_access_iterator_tag)
+    {
+        std::size_t n = std::size_t(end - beg);
+        unsigned parts = partCount(policy, n);
+        std::vector<Iter> mins(parts, end);
+
+        runParts(parts, [&](unsigned i, unsigned count)
+                 { mins[i] = auMinElement(beg + partBegin(n, i, count), beg + partBegin(n, i + 1, count), pred); });
+
+        Iter min = mins[0];
+        for (unsigned i = 1; i < parts; i++)
+        {
+            if (pred(*mins[i], *min))
+            {
+                min = mins[i];
+            }
+        }
+
+        return min;
+    }
+
+    template <typename Iter, typename Predicate>
+    Iter parallelMinElement(const AuParallel &, Iter beg, Iter end, Predicate pred, std::forward_iterator_tag)
+    {
+        return auMinElement(beg, end, pred);
+    }
+
+    template <typename Iter>
+    Iter parallelMinElement(const AuParallel &policy, Iter beg, Iter end, std::random_access_iterator_tag)
+    {
+        std::size_t n = std::size_t(end - beg);
+        unsigned parts = partCount(policy, n);
+        std::vector<Iter> mins(parts, end);
+
+        runParts(parts, [&](unsigned i, unsigned count)
+                 { mins[i] = auMinElement(beg + partBegin(n, i, count), beg + partBegin(n, i + 1, count)); });
+
+        Iter min = mins[0];
+        for (unsigned i = 1; i < parts; i++)
+        {
+            if (*mins[i] < *min)
+            {
+                min = mins[i];
+            }
+        }
+
+        return min;
+    }
+
+    template <typename Iter>
+    Iter parallelMinElement(const AuParallel &, Iter beg, Iter end, std::forward_iterator_tag)
+    {
+        return auMinElement(beg, end);
+    }
+
+    // Part i swaps its share of the first half with the mirrored share of
+    // the second.
+    template <typename Iter>
+    void parallelReverse(const AuParallel &policy, Iter beg, Iter end, std::random_access_iterator_tag)
+    {
+        std::size_t n = std::size_t(end - beg), half = n / 2;
+
+        runParts(partCount(policy, half), [&](unsigned i, unsigned parts)
+                 {
+                     std::size_t last = partBegin(half, i + 1, parts);
+                     for (std::size_t j = partBegin(half, i, parts); j < last; j++)
+                     {
+                         auSwap(beg[j], beg[n - 1 - j]);
+                     }
+                 });
+    }
+
+    template <typename Iter>
+    void parallelReverse(const AuParallel &, Iter beg, Iter end, std::bidirectional_iterator_tag)
+    {
+        auReverse(beg, end);
+    }
 }
 
-template <typename ForwardIter, typename T>
-ForwardIter auLowerBound(ForwardIter beg, ForwardIter end, const T &k)
+template <typename ForwardIter, typename Key>
+ForwardIter auFind(const AuParallel &policy, ForwardIter beg, ForwardIter end, const Key &key)
+{
+    return au_detail::parallelFind(policy, beg, end, key, typename std::iterator_traits<ForwardIter>::iterator_category());
+}
+
+// Each part stops at its own first match, but parts run concurrently, so
+// pred is called from several threads at once and on elements past the
+// first match of the whole range. It must be safe to call concurrently
+// and free of side effects.
+template <typename ForwardIter, typename UnaryPredicate>
+ForwardIter auFindIf(const AuParallel &policy, ForwardIter beg, ForwardIter end, UnaryPredicate pred)
+{
+    return au_detail::parallelFindIf(policy, beg, end, pred, typename std::iterator_traits<ForwardIter>::iterator_category());
+}
+
+template <typename ForwardIter>
+ForwardIter auMinElement(const AuParallel &policy, ForwardIter beg, ForwardIter end)
+{
+    return au_detail::parallelMinElement(policy, beg, end, typename std::iterator_traits<ForwardIter>::iterator_category());
+}
+
+template <typename ForwardIter, typename Predicate>
+ForwardIter auMinElement(const AuParallel &policy, ForwardIter beg, ForwardIter end, Predicate pred)
+{
+    return au_detail::parallelMinElement(policy, beg, end, pred, typename std::iterator_traits<ForwardIter>::iterator_category());
+}
+
+template <typename BidirectionalIter>
+void auReverse(const AuParallel &policy, BidirectionalIter beg, BidirectionalIter end)
 {
-    while (beg != end)
+    au_detail::parallelReverse(policy, beg, end, typename std::iterator_traits<BidirectionalIter>::iterator_category());
+}
+
+namespace au_detail
+{
+    // Hints the cache to fetch the element at it; a no-op for iterators
+    // whose elements have no address, such as proxies.
+    template <typename Iter>
+    void prefetch(Iter it, std::true_type)
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(static_cast<const void *>(&*it));
+#else
+        (void)it;
+#endif
+    }
+
+    template <typename Iter>
+    void prefetch(Iter, std::false_type)
+    {
+    }
+
+    template <typename Iter>
+    void prefetch(Iter it)
+    {
+        prefetch(it, std::is_lvalue_reference<typename std::iterator_traits<Iter>::reference>());
+    }
+
+    template <typename ForwardIter, typename T>
+    ForwardIter lowerBound(ForwardIter beg, ForwardIter end, const T &k, std::forward_iterator_tag)
     {
-        auto mid = beg + (end - beg) / 2;
-        if (*mid < k)
+        auto n = std::distance(beg, end);
+
+        while (n > 0)
         {
-            beg = ++mid;
+            auto half = n / 2;
+            auto mid = beg;
+            std::advance(mid, half);
+
+            if (*mid < k)
+            {
+                beg = ++mid;
+                n -= half + 1;
+            }
+            else
+            {
+                n = half;
+            }
         }
-        else
+
+        return beg;
+    }
+
+    // Halves the range without branching on the comparison, so the
+    // compiler can select the next base with a conditional move; both
+    // midpoints the following step could probe are prefetched meanwhile.
+    template <typename RandomIter, typename T>
+    RandomIter lowerBound(RandomIter beg, RandomIter end, const T &k, std::random_access_iterator_tag)
+    {
+        auto n = end - beg;
+
+        if (n == 0)
+        {
+            return beg;
+        }
+
+        while (n > 1)
         {
-            end = mid;
+            auto half = n / 2;
+            prefetch(beg + half / 2);
+            prefetch(beg + half + half / 2);
+            beg = (beg[half] < k) ? beg + half : beg;
+            n -= half;
         }
+
+        return beg + (*beg < k ? 1 : 0);
     }
+}
 
-    return beg;
+template <typename ForwardIter, typename T>
+ForwardIter auLowerBound(ForwardIter beg, ForwardIter end, const T &k)
+{
+    return au_detail::lowerBound(beg, end, k, typename std::iterator_traits<ForwardIter>::iterator_category());
 }
 
 template <typename ForwardIter, typename T>
@@ -123,3 +785,681 @@ bool auBinarySearch(ForwardIter beg, ForwardIter end, const T &value)
     auto iter = auLowerBound(beg, end, value);
     return iter != end && value >= *iter;
 }
+
+// Read-only copy of a sorted range laid out in Eytzinger (breadth-first
+// binary tree) order: the children of node k are 2k and 2k + 1. A search
+// walks down from the root touching one node per level, and the nodes
+// four levels below all share a few cache lines, so prefetching them
+// while the current comparison resolves hides most of the misses a
+// binary search over the sorted array takes. Queries return positions
+// in the original sorted order.
+template <typename T>
+class AuStaticIndex
+{
+public:
+    AuStaticIndex() : mPosition(1, 0)
+    {
+    }
+
+    // [beg, end) must be sorted by operator<.
+    template <typename InputIter>
+    AuStaticIndex(InputIter beg, InputIter end) : mPosition(1, 0)
+    {
+        std::vector<T> sorted(beg, end);
+
+        if (sorted.empty())
+        {
+            return;
+        }
+
+        mTree.assign(sorted.size() + 1, sorted[0]);
+        mPosition.assign(sorted.size() + 1, sorted.size());
+
+        std::size_t next = 0;
+        build(sorted, next, 1);
+    }
+
+    std::size_t size() const
+    {
+        return mTree.empty() ? 0 : mTree.size() - 1;
+    }
+
+    // Position of the first element not less than key, or size().
+    std::size_t lowerBound(const T &key) const
+    {
+        const T *tree = mTree.data();
+        std::size_t k = 1, n = size();
+
+        while (k <= n)
+        {
+            prefetch(tree, k);
+            k = 2 * k + (tree[k] < key ? 1 : 0);
+        }
+
+        return mPosition[climb(k)];
+    }
+
+    // Position of the first element greater than key, or size().
+    std::size_t upperBound(const T &key) const
+    {
+        const T *tree = mTree.data();
+        std::size_t k = 1, n = size();
+
+        while (k <= n)
+        {
+            prefetch(tree, k);
+            k = 2 * k + (key < tree[k] ? 0 : 1);
+        }
+
+        return mPosition[climb(k)];
+    }
+
+    bool contains(const T &key) const
+    {
+        const T *tree = mTree.data();
+        std::size_t k = 1, n = size();
+
+        while (k <= n)
+        {
+            prefetch(tree, k);
+            k = 2 * k + (tree[k] < key ? 1 : 0);
+        }
+
+        k = climb(k);
+        return k != 0 && !(key < mTree[k]);
+    }
+
+    // [lowerBound(key), upperBound(key))
+    std::pair<std::size_t, std::size_t> equalRange(const T &key) const
+    {
+        return std::make_pair(lowerBound(key), upperBound(key));
+    }
+
+private:
+    // mTree[0] and mPosition[0] stand for "past the end"
+    std::vector<T> mTree;
+    std::vector<std::size_t> mPosition;
+
+    // Nodes per cache line; the descendants of k log2(LINE) levels down
+    // start at node k * LINE.
+    static const std::size_t LINE = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+
+    void build(const std::vector<T> &sorted, std::size_t &next, std::size_t k)
+    {
+        if (k < mTree.size())
+        {
+            build(sorted, next, 2 * k);
+            mTree[k] = sorted[next];
+            mPosition[k] = next++;
+            build(sorted, next, 2 * k + 1);
+        }
+    }
+
+    // Touches the first of the descendants of k LINE levels down. The
+    // address is formed as an integer since it may lie past the tree;
+    // prefetching it is harmless either way.
+    static void prefetch(const T *tree, std::size_t k)
+    {
+#if defined(__GNUC__)
+        std::uintptr_t ahead = reinterpret_cast<std::uintptr_t>(tree) + k * LINE * sizeof(T);
+        __builtin_prefetch(reinterpret_cast<const void *>(ahead));
+#else
+        (void)tree;
+        (void)k;
+#endif
+    }
+
+    // The walk ends below a leaf; the answer is the last node where it
+    // went left, found by dropping the trailing right turns and that one
+    // left turn. 0 means it never went left.
+    static std::size_t climb(std::size_t k)
+    {
+#if defined(__GNUC__)
+        return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+#else
+        while (k & 1)
+        {
+            k >>= 1;
+        }
+        return k >> 1;
+#endif
+    }
+};
+
+namespace au_detail
+{
+    struct Less
+    {
+        template <typename A, typename B>
+        bool operator()(const A &a, const B &b) const
+        {
+            return a < b;
+        }
+    };
+
+    // Comparators cheap enough, on arithmetic values, for block
+    // partitioning to beat a branch per element.
+    template <typename T, typename Compare>
+    struct IsCheapCompare
+        : std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                           (std::is_same<Compare, Less>::value ||
+                                            std::is_same<Compare, std::less<T>>::value ||
+                                            std::is_same<Compare, std::greater<T>>::value)>
+    {
+    };
+
+    const std::ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+    const std::ptrdiff_t NINTHER_THRESHOLD = 128;
+    const std::ptrdiff_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+    const std::size_t PARTITION_BLOCK = 64;
+
+    template <typename Iter>
+    void iterSwap(Iter a, Iter b)
+    {
+        auSwap(*a, *b);
+    }
+
+    template <typename Iter, typename Compare>
+    void sort2(Iter a, Iter b, Compare &comp)
+    {
+        if (comp(*b, *a))
+        {
+            iterSwap(a, b);
+        }
+    }
+
+    template <typename Iter, typename Compare>
+    void sort3(Iter a, Iter b, Iter c, Compare &comp)
+    {
+        sort2(a, b, comp);
+        sort2(b, c, comp);
+        sort2(a, b, comp);
+    }
+
+    // Moves *cur left to its place; with guarded unset the caller
+    // promises an element not greater than it sits before beg. Returns
+    // how far it moved.
+    template <typename Iter, typename Compare>
+    std::ptrdiff_t siftLeft(Iter beg, Iter cur, Compare &comp, bool guarded)
+    {
+        typedef typename std::iterator_traits<Iter>::value_type T;
+
+        Iter sift = cur, prev = cur - 1;
+
+        if (!comp(*sift, *prev))
+        {
+            return 0;
+        }
+
+        T t = std::move(*sift);
+        do
+        {
+            *sift-- = std::move(*prev);
+        } while ((!guarded || sift != beg) && comp(t, *--prev));
+        *sift = std::move(t);
+
+        return cur - sift;
+    }
+
+    template <typename Iter, typename Compare>
+    void insertionSort(Iter beg, Iter end, Compare &comp, bool guarded)
+    {
+        if (beg == end)
+        {
+            return;
+        }
+
+        for (Iter cur = beg + 1; cur != end; ++cur)
+        {
+            siftLeft(beg, cur, comp, guarded);
+        }
+    }
+
+    // Insertion sort that gives up once it has moved elements more than
+    // PARTIAL_INSERTION_SORT_LIMIT places in total; true if it finished.
+    template <typename Iter, typename Compare>
+    bool partialInsertionSort(Iter beg, Iter end, Compare &comp)
+    {
+        if (beg == end)
+        {
+            return true;
+        }
+
+        std::ptrdiff_t moved = 0;
+        for (Iter cur = beg + 1; cur != end; ++cur)
+        {
+            moved += siftLeft(beg, cur, comp, true);
+            if (moved > PARTIAL_INSERTION_SORT_LIMIT)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Iter, typename Compare>
+    void siftDown(Iter beg, std::ptrdiff_t n, std::ptrdiff_t i, Compare &comp)
+    {
+        typedef typename std::iterator_traits<Iter>::value_type T;
+
+        T t = std::move(beg[i]);
+
+        for (std::ptrdiff_t child = 2 * i + 1; child < n; child = 2 * i + 1)
+        {
+            if (child + 1 < n && comp(beg[child], beg[child + 1]))
+            {
+                child++;
+            }
+            if (!comp(t, beg[child]))
+            {
+                break;
+            }
+            beg[i] = std::move(beg[child]);
+            i = child;
+        }
+
+        beg[i] = std::move(t);
+    }
+
+    template <typename Iter, typename Compare>
+    void heapSort(Iter beg, Iter end, Compare &comp)
+    {
+        std::ptrdiff_t n = end - beg;
+
+        for (std::ptrdiff_t i = n / 2; i-- > 0;)
+        {
+            siftDown(beg, n, i, comp);
+        }
+
+        for (std::ptrdiff_t last = n - 1; last > 0; last--)
+        {
+            iterSwap(beg, beg + last);
+            siftDown(beg, last, 0, comp);
+        }
+    }
+
+    // Partitions [beg, end) around the pivot *beg into elements less than
+    // it and elements not less than it, and returns the pivot's final
+    // position and whether no element had to move. Needs an element not
+    // less than the pivot somewhere after it, which the median selection
+    // guarantees.
+    template <typename Iter, typename Compare>
+    std::pair<Iter, bool> partitionRight(Iter beg, Iter end, Compare &comp)
+    {
+        typedef typename std::iterator_traits<Iter>::value_type T;
+
+        T pivot = std::move(*beg);
+        Iter first = beg, last = end;
+
+        while (comp(*++first, pivot))
+        {
+        }
+
+        if (first - 1 == beg)
+        {
+            while (first < last && !comp(*--last, pivot))
+            {
+            }
+        }
+        else
+        {
+            while (!comp(*--last, pivot))
+            {
+            }
+        }
+
+        bool alreadyPartitioned = first >= last;
+
+        while (first < last)
+        {
+            iterSwap(first, last);
+            while (comp(*++first, pivot))
+            {
+            }
+            while (!comp(*--last, pivot))
+            {
+            }
+        }
+
+        Iter pivotPos = first - 1;
+        *beg = std::move(*pivotPos);
+        *pivotPos = std::move(pivot);
+
+        return std::make_pair(pivotPos, alreadyPartitioned);
+    }
+
+    // Moves num pairs of misplaced elements, given as offsets from first
+    // and back from last, across the partition; a cyclic rotation needs
+    // fewer moves than swaps but swaps keep descending input linear.
+    template <typename Iter>
+    void swapOffsets(Iter first, Iter last, const unsigned char *left, const unsigned char *right,
+                     std::size_t num, bool useSwaps)
+    {
+        typedef typename std::iterator_traits<Iter>::value_type T;
+
+        if (useSwaps)
+        {
+            for (std::size_t i = 0; i < num; i++)
+            {
+                iterSwap(first + left[i], last - right[i]);
+            }
+        }
+        else if (num > 0)
+        {
+            Iter l = first + left[0], r = last - right[0];
+            T t = std::move(*l);
+            *l = std::move(*r);
+
+            for (std::size_t i = 1; i < num; i++)
+            {
+                l = first + left[i];
+                *r = std::move(*l);
+                r = last - right[i];
+                *l = std::move(*r);
+            }
+
+            *r = std::move(t);
+        }
+    }
+
+    // partitionRight without data-dependent branches in the scan, after
+    // Edelkamp and Weiss' BlockQuicksort: the comparisons of a block on
+    // each side only record the offsets of misplaced elements, which are
+    // then swapped pairwise.
+    template <typename Iter, typename Compare>
+    std::pair<Iter, bool> partitionRightBranchless(Iter beg, Iter end, Compare &comp)
+    {
+        typedef typename std::iterator_traits<Iter>::value_type T;
+
+        T pivot = std::move(*beg);
+        Iter first = beg, last = end;
+
+        while (comp(*++first, pivot))
+        {
+        }
+
+        if (first - 1 == beg)
+        {
+            while (first < last && !comp(*--last, pivot))
+            {
+            }
+        }
+        else
+        {
+            while (!comp(*--last, pivot))
+            {
+            }
+        }
+
+        bool alreadyPartitioned = first >= last;
+
+        if (!alreadyPartitioned)
+        {
+            iterSwap(first, last);
+            ++first;
+
+            unsigned char left[PARTITION_BLOCK], right[PARTITION_BLOCK];
+            Iter leftBase = first, rightBase = last;
+            std::size_t numLeft = 0, numRight = 0, startLeft = 0, startRight = 0;
+
+            while (first < last)
+            {
+                // refill whichever offset blocks ran empty, splitting what
+                // is left between them when both did
+                std::size_t unknown = std::size_t(last - first);
+                std::size_t leftSplit = numLeft == 0 ? (numRight == 0 ? unknown / 2 : unknown) : 0;
+                std::size_t rightSplit = numRight == 0 ? unknown - leftSplit : 0;
+
+                std::size_t leftCount = leftSplit < PARTITION_BLOCK ? leftSplit : PARTITION_BLOCK;
+                for (std::size_t i = 0; i < leftCount; i++)
+                {
+                    left[numLeft] = static_cast<unsigned char>(i);
+                    numLeft += !comp(*first, pivot) ? 1 : 0;
+                    ++first;
+                }
+
+                std::size_t rightCount = rightSplit < PARTITION_BLOCK ? rightSplit : PARTITION_BLOCK;
+                for (std::size_t i = 1; i <= rightCount; i++)
+                {
+                    right[numRight] = static_cast<unsigned char>(i);
+                    numRight += comp(*--last, pivot) ? 1 : 0;
+                }
+
+                std::size_t num = numLeft < numRight ? numLeft : numRight;
+                swapOffsets(leftBase, rightBase, left + startLeft, right + startRight, num, numLeft == numRight);
+                numLeft -= num;
+                numRight -= num;
+                startLeft += num;
+                startRight += num;
+
+                if (numLeft == 0)
+                {
+                    startLeft = 0;
+                    leftBase = first;
+                }
+
+                if (numRight == 0)
+                {
+                    startRight = 0;
+                    rightBase = last;
+                }
+            }
+
+            // one side may still hold misplaced elements; they go next to
+            // the boundary
+            while (numLeft > 0)
+            {
+                numLeft--;
+                iterSwap(leftBase + left[startLeft + numLeft], --last);
+                first = last;
+            }
+
+            while (numRight > 0)
+            {
+                numRight--;
+                iterSwap(rightBase - right[startRight + numRight], first);
+                ++first;
+                last = first;
+            }
+        }
+
+        Iter pivotPos = first - 1;
+        *beg = std::move(*pivotPos);
+        *pivotPos = std::move(pivot);
+
+        return std::make_pair(pivotPos, alreadyPartitioned);
+    }
+
+    // Puts the elements equal to the pivot *beg left of those greater than
+    // it, given that nothing in the range is less than it; returns the
+    // pivot's final position.
+    template <typename Iter, typename Compare>
+    Iter partitionLeft(Iter beg, Iter end, Compare &comp)
+    {
+        typedef typename std::iterator_traits<Iter>::value_type T;
+
+        T pivot = std::move(*beg);
+        Iter first = beg, last = end;
+
+        while (comp(pivot, *--last))
+        {
+        }
+
+        if (last + 1 == end)
+        {
+            while (first < last && !comp(pivot, *++first))
+            {
+            }
+        }
+        else
+        {
+            while (!comp(pivot, *++first))
+            {
+            }
+        }
+
+        while (first < last)
+        {
+            iterSwap(first, last);
+            while (comp(pivot, *--last))
+            {
+            }
+            while (!comp(pivot, *++first))
+            {
+            }
+        }
+
+        *beg = std::move(*last);
+        *last = std::move(pivot);
+
+        return last;
+    }
+
+    // Pattern-defeating quicksort (Orson Peters): quicksort with a median
+    // of three, or Tukey's ninther on large ranges, as pivot; runs of
+    // elements equal to the previous pivot are split off in one pass;
+    // partitions that moved nothing are finished by a bounded insertion
+    // sort, which makes sorted runs linear; and after badAllowed badly
+    // unbalanced partitions the range is heap sorted instead.
+    template <typename Iter, typename Compare, bool Branchless>
+    void pdqSort(Iter beg, Iter end, Compare &comp, int badAllowed, bool leftmost)
+    {
+        for (;;)
+        {
+            std::ptrdiff_t size = end - beg;
+
+            if (size < INSERTION_SORT_THRESHOLD)
+            {
+                insertionSort(beg, end, comp, leftmost);
+                return;
+            }
+
+            std::ptrdiff_t s2 = size / 2;
+            if (size > NINTHER_THRESHOLD)
+            {
+                sort3(beg, beg + s2, end - 1, comp);
+                sort3(beg + 1, beg + (s2 - 1), end - 2, comp);
+                sort3(beg + 2, beg + (s2 + 1), end - 3, comp);
+                sort3(beg + (s2 - 1), beg + s2, beg + (s2 + 1), comp);
+                iterSwap(beg, beg + s2);
+            }
+            else
+            {
+                sort3(beg + s2, beg, end - 1, comp);
+            }
+
+            // the element before a non-leftmost range is the previous pivot,
+            // so if it is not less than this one the range starts with a run
+            // of equal elements
+            if (!leftmost && !comp(*(beg - 1), *beg))
+            {
+                beg = partitionLeft(beg, end, comp) + 1;
+                continue;
+            }
+
+            std::pair<Iter, bool> part =
+                Branchless ? partitionRightBranchless(beg, end, comp) : partitionRight(beg, end, comp);
+            Iter pivotPos = part.first;
+
+            std::ptrdiff_t leftSize = pivotPos - beg;
+            std::ptrdiff_t rightSize = end - (pivotPos + 1);
+
+            if (leftSize < size / 8 || rightSize < size / 8)
+            {
+                if (--badAllowed == 0)
+                {
+                    heapSort(beg, end, comp);
+                    return;
+                }
+
+                // break up patterns that may have caused the imbalance
+                if (leftSize >= INSERTION_SORT_THRESHOLD)
+                {
+                    iterSwap(beg, beg + leftSize / 4);
+                    iterSwap(pivotPos - 1, pivotPos - leftSize / 4);
+
+                    if (leftSize > NINTHER_THRESHOLD)
+                    {
+                        iterSwap(beg + 1, beg + (leftSize / 4 + 1));
+                        iterSwap(beg + 2, beg + (leftSize / 4 + 2));
+                        iterSwap(pivotPos - 2, pivotPos - (leftSize / 4 + 1));
+                        iterSwap(pivotPos - 3, pivotPos - (leftSize / 4 + 2));
+                    }
+                }
+
+                if (rightSize >= INSERTION_SORT_THRESHOLD)
+                {
+                    iterSwap(pivotPos + 1, pivotPos + (1 + rightSize / 4));
+                    iterSwap(end - 1, end - rightSize / 4);
+
+                    if (rightSize > NINTHER_THRESHOLD)
+                    {
+                        iterSwap(pivotPos + 2, pivotPos + (2 + rightSize / 4));
+                        iterSwap(pivotPos + 3, pivotPos + (3 + rightSize / 4));
+                        iterSwap(end - 2, end - (1 + rightSize / 4));
+                        iterSwap(end - 3, end - (2 + rightSize / 4));
+                    }
+                }
+            }
+            else if (part.second && partialInsertionSort(beg, pivotPos, comp) &&
+                     partialInsertionSort(pivotPos + 1, end, comp))
+            {
+                return;
+            }
+
+            pdqSort<Iter, Compare, Branchless>(beg, pivotPos, comp, badAllowed, leftmost);
+            beg = pivotPos + 1;
+            leftmost = false;
+        }
+    }
+}
+
+// Sorts [beg, end) by comp, not stably, in O(n log n) worst case. Input
+// that is already sorted, or sorted in reverse, is recognized in one pass
+// and costs O(n).
+template <typename RandomIter, typename Compare>
+void auSort(RandomIter beg, RandomIter end, Compare comp)
+{
+    typedef typename std::iterator_traits<RandomIter>::value_type T;
+
+    std::ptrdiff_t n = end - beg;
+    if (n < 2)
+    {
+        return;
+    }
+
+    // stops at the first element that rules out both directions
+    bool ascending = true, descending = true;
+    for (RandomIter it = beg + 1; it != end && (ascending || descending); ++it)
+    {
+        ascending = ascending && !comp(*it, *(it - 1));
+        descending = descending && !comp(*(it - 1), *it);
+    }
+
+    if (ascending)
+    {
+        return;
+    }
+
+    if (descending)
+    {
+        auReverse(beg, end);
+        return;
+    }
+
+    int log2n = 0;
+    for (std::ptrdiff_t m = n; m > 1; m /= 2)
+    {
+        log2n++;
+    }
+
+    au_detail::pdqSort<RandomIter, Compare, au_detail::IsCheapCompare<T, Compare>::value>(beg, end, comp, log2n,
+                                                                                            true);
+}
+
+template <typename RandomIter>
+void auSort(RandomIter beg, RandomIter end)
+{
+    auSort(beg, end, au_detail::Less());
+}
@@ -0,0 +1,243 @@
+// Benchmark of auSort against std::sort: plain ints in several input
+// patterns, then the element types and comparators the lab06 and
+// project02 solutions sort with. Reports ns per element for both and the
+// speedup, on stdout and as CSV.
+//
+// usage: ./main [csv-file] [max-elements]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../algol.hpp"
+
+using namespace std;
+
+struct Result
+{
+    string workload;
+    size_t n;
+    double stdNs;
+    double auNs;
+};
+
+// ns per element of sorting a fresh copy of input, averaged over as many
+// runs as fit in 200 ms
+template <typename T, typename Sort>
+double measure(const vector<T> &input, Sort sortRange)
+{
+    using Clock = chrono::steady_clock;
+    const auto minTime = chrono::milliseconds(200);
+
+    auto elapsed = Clock::duration::zero();
+    long long runs = 0;
+
+    do
+    {
+        vector<T> v = input;
+        auto start = Clock::now();
+        sortRange(v.begin(), v.end());
+        elapsed += Clock::now() - start;
+        runs++;
+    } while (elapsed < minTime);
+
+    return chrono::duration<double, nano>(elapsed).count() / runs / max<size_t>(input.size(), 1);
+}
+
+template <typename T, typename Compare>
+Result compare(const string &name, const vector<T> &input, Compare comp)
+{
+    double stdNs = measure(input, [&](typename vector<T>::iterator b, typename vector<T>::iterator e)
+                           { sort(b, e, comp); });
+    double auNs = measure(input, [&](typename vector<T>::iterator b, typename vector<T>::iterator e)
+                          { auSort(b, e, comp); });
+
+    vector<T> a = input, b = input;
+    sort(a.begin(), a.end(), comp);
+    auSort(b.begin(), b.end(), comp);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        // equal elements may come out in either order
+        if (comp(a[i], b[i]) || comp(b[i], a[i]))
+        {
+            cerr << name << ": auSort disagrees with std::sort\n";
+            exit(1);
+        }
+    }
+
+    return {name, input.size(), stdNs, auNs};
+}
+
+// lab06 p06, p07
+struct Student
+{
+    string mName;
+    double mGpa;
+};
+
+// project02 p01
+struct CompByMod
+{
+    int m;
+
+    explicit CompByMod(int aM) : m(aM) {}
+
+    bool operator()(const int a, const int b) const
+    {
+        int rA = a % m;
+        int rB = b % m;
+
+        if (rA != rB)
+        {
+            return rA < rB;
+        }
+
+        if (a % 2 != 0 && b % 2 != 0)
+        {
+            return a > b;
+        }
+
+        if (a % 2 != 0 && b % 2 == 0)
+        {
+            return true;
+        }
+
+        if (a % 2 == 0 && b % 2 != 0)
+        {
+            return false;
+        }
+
+        return a < b;
+    }
+};
+
+// project02 p03
+struct Freq
+{
+    char letter;
+    int count;
+};
+
+string randomName(mt19937 &gen)
+{
+    string s = "Student";
+    for (int i = 0, len = 3 + int(gen() % 6); i < len; i++)
+    {
+        s += char('A' + gen() % 26);
+    }
+    return s;
+}
+
+int main(int argc, char *argv[])
+{
+    string csvPath = argc > 1 ? argv[1] : "sort.csv";
+    size_t maxElements = argc > 2 ? size_t(atol(argv[2])) : 1000000;
+
+    vector<size_t> sizes;
+    for (size_t n = 1000; n <= maxElements; n *= 10)
+    {
+        sizes.push_back(n);
+    }
+
+    mt19937 gen(25);
+    vector<Result> results;
+
+    for (size_t n : sizes)
+    {
+        vector<int> random(n), sorted(n), reversed(n), fewUnique(n), organPipe(n), nearlySorted(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            random[i] = int(gen() % 1000000000);
+            sorted[i] = int(i);
+            reversed[i] = int(n - i);
+            fewUnique[i] = int(gen() % 16);
+            organPipe[i] = int(i < n / 2 ? i : n - i);
+            nearlySorted[i] = int(i);
+        }
+        for (size_t i = 0; i < n / 100; i++)
+        {
+            swap(nearlySorted[gen() % n], nearlySorted[gen() % n]);
+        }
+
+        less<int> byValue;
+        results.push_back(compare("int random", random, byValue));
+        results.push_back(compare("int sorted", sorted, byValue));
+        results.push_back(compare("int reversed", reversed, byValue));
+        results.push_back(compare("int few unique", fewUnique, byValue));
+        results.push_back(compare("int organ pipe", organPipe, byValue));
+        results.push_back(compare("int nearly sorted", nearlySorted, byValue));
+
+        results.push_back(compare("p01 CompByMod", random, CompByMod(1000)));
+
+        vector<Student> students(n);
+        for (auto &s : students)
+        {
+            s.mName = randomName(gen);
+            s.mGpa = double(gen() % 401) / 100;
+        }
+        results.push_back(compare("p06 by name", students, [](const Student &s1, const Student &s2)
+                                  { return s1.mName < s2.mName; }));
+        results.push_back(compare("p06 by gpa", students, [](const Student &s1, const Student &s2)
+                                  { return s1.mGpa > s2.mGpa; }));
+
+        vector<pair<string, double>> pairs(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            pairs[i] = make_pair(students[i].mName, students[i].mGpa);
+        }
+        results.push_back(compare("p08 pair", pairs, less<pair<string, double>>()));
+
+        vector<tuple<string, int, double>> employees(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            employees[i] = make_tuple(students[i].mName, int(18 + gen() % 50), double(gen() % 100000));
+        }
+        results.push_back(compare("p09 by age", employees, [](const tuple<string, int, double> &e1, const tuple<string, int, double> &e2)
+                                  { return get<1>(e1) < get<1>(e2); }));
+
+        vector<Freq> freqs(n);
+        for (auto &f : freqs)
+        {
+            f = {char('A' + gen() % 26), int(gen() % 1000)};
+        }
+        results.push_back(compare("p03 by count", freqs, [](Freq a, Freq b)
+                                  { return a.count > b.count; }));
+
+        if (n <= 100000)
+        {
+            vector<string> words(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                words[i] = students[i].mName.substr(7);
+            }
+            results.push_back(compare("p13 reversed", words, [](string a, string b)
+                                      {
+                                          reverse(begin(a), end(a));
+                                          reverse(begin(b), end(b));
+                                          return a < b; }));
+        }
+
+        cerr << n << " elements done\n";
+    }
+
+    ofstream csv(csvPath);
+    csv << "workload,n,std_ns_per_element,au_ns_per_element,speedup\n";
+
+    printf("%-18s %8s %12s %12s %8s\n", "workload", "n", "std ns/el", "au ns/el", "speedup");
+    for (const auto &r : results)
+    {
+        csv << r.workload << "," << r.n << "," << r.stdNs << "," << r.auNs << "," << r.stdNs / r.auNs << "\n";
+        printf("%-18s %8zu %12.2f %12.2f %8.2f\n", r.workload.c_str(), r.n, r.stdNs, r.auNs, r.stdNs / r.auNs);
+    }
+
+    cerr << "wrote " << csvPath << "\n";
+}
@@ -0,0 +1,399 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest/doctest.h"
+#include <algorithm>
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "algol.hpp"
+
+using namespace std;
+
+// Empty, single, around a 32-element block and around a 4096-element
+// chunk.
+static const size_t SIZES[] = {0, 1, 2, 31, 32, 33, 4095, 4096, 4097};
+
+TEST_CASE("auLowerBound and auBinarySearch match the std algorithms")
+{
+    for (size_t n : SIZES)
+    {
+        CAPTURE(n);
+
+        // 0, 2, 4, ...: every key below, between, on and above the elements
+        vector<int> v;
+        for (size_t i = 0; i < n; i++)
+        {
+            v.push_back(int(2 * i));
+        }
+        list<int> l(v.begin(), v.end());
+
+        // every key for the short ranges, the ends and a sample between
+        // for the long ones, as the debug-mode std algorithms are linear
+        for (int k = -1; k <= int(2 * n); k += (n < 64 || k < 3 || k > int(2 * n) - 3) ? 1 : 97)
+        {
+            CAPTURE(k);
+            REQUIRE(auLowerBound(v.begin(), v.end(), k) == lower_bound(v.begin(), v.end(), k));
+            REQUIRE(auBinarySearch(v.begin(), v.end(), k) == binary_search(v.begin(), v.end(), k));
+            REQUIRE(distance(l.begin(), auLowerBound(l.begin(), l.end(), k)) ==
+                    distance(v.begin(), lower_bound(v.begin(), v.end(), k)));
+            REQUIRE(auBinarySearch(l.begin(), l.end(), k) == binary_search(v.begin(), v.end(), k));
+        }
+
+        vector<int> same(n, 7);
+        for (int k = 6; k <= 8; k++)
+        {
+            REQUIRE(auLowerBound(same.begin(), same.end(), k) == lower_bound(same.begin(), same.end(), k));
+            REQUIRE(auBinarySearch(same.begin(), same.end(), k) == binary_search(same.begin(), same.end(), k));
+        }
+    }
+
+    const int a[] = {1, 3, 3, 3, 8};
+    REQUIRE(auLowerBound(a, a + 5, 3) == a + 1);
+    REQUIRE(auLowerBound(a, a + 5, 9) == a + 5);
+    REQUIRE_FALSE(auBinarySearch(a, a + 5, 2));
+}
+
+TEST_CASE("AuStaticIndex matches the std algorithms on the sorted range")
+{
+    for (size_t n : SIZES)
+    {
+        CAPTURE(n);
+
+        // runs of three equal elements, 0, 0, 0, 2, 2, 2, ...
+        vector<int> v;
+        for (size_t i = 0; i < n; i++)
+        {
+            v.push_back(int(i / 3 * 2));
+        }
+        list<int> l(v.begin(), v.end());
+        AuStaticIndex<int> index(l.begin(), l.end());
+        REQUIRE(index.size() == n);
+
+        int last = n == 0 ? 0 : v.back();
+        for (int k = -1; k <= last + 1; k += (n < 64 || k < 3 || k > last - 3) ? 1 : 97)
+        {
+            CAPTURE(k);
+            size_t lo = size_t(lower_bound(v.begin(), v.end(), k) - v.begin());
+            size_t hi = size_t(upper_bound(v.begin(), v.end(), k) - v.begin());
+
+            REQUIRE(index.lowerBound(k) == lo);
+            REQUIRE(index.upperBound(k) == hi);
+            REQUIRE(index.contains(k) == binary_search(v.begin(), v.end(), k));
+            REQUIRE(index.equalRange(k) == make_pair(lo, hi));
+        }
+
+        vector<int> same(n, 7);
+        AuStaticIndex<int> sameIndex(same.begin(), same.end());
+        REQUIRE(sameIndex.lowerBound(7) == 0);
+        REQUIRE(sameIndex.upperBound(7) == n);
+        REQUIRE(sameIndex.contains(7) == (n != 0));
+        REQUIRE(sameIndex.equalRange(8) == make_pair(n, n));
+    }
+
+    AuStaticIndex<int> empty;
+    REQUIRE(empty.size() == 0);
+    REQUIRE(empty.lowerBound(1) == 0);
+    REQUIRE(empty.upperBound(1) == 0);
+    REQUIRE_FALSE(empty.contains(1));
+}
+
+// Positions in a range of n elements worth planting a match at.
+static vector<size_t> probes(size_t n)
+{
+    vector<size_t> at;
+    for (size_t p : {size_t(0), size_t(1), size_t(31), size_t(32), size_t(33), size_t(4095), size_t(4096), n / 2, n - 2, n - 1})
+    {
+        if (p < n)
+        {
+            at.push_back(p);
+        }
+    }
+    return at;
+}
+
+template <typename T>
+void checkSearches(size_t n)
+{
+    CAPTURE(n);
+    CAPTURE(sizeof(T));
+
+    // n, n - 1, ..., n - 99, n, n - 1, ...: the minimum repeats every 100
+    vector<T> v;
+    for (size_t i = 0; i < n; i++)
+    {
+        v.push_back(T(n - i % 100));
+    }
+
+    REQUIRE(auMinElement(v.begin(), v.end()) == min_element(v.begin(), v.end()));
+    REQUIRE(auFind(v.begin(), v.end(), T(0)) == v.end());
+
+    for (size_t p : probes(n))
+    {
+        CAPTURE(p);
+        vector<T> w(v);
+        w[p] = T(0);
+
+        REQUIRE(auFind(w.begin(), w.end(), T(0)) == w.begin() + p);
+        REQUIRE(auFind(w.data(), w.data() + n, T(0)) == w.data() + p);
+        REQUIRE(auFindIf(w.begin(), w.end(), [](T x)
+                         { return x == T(0); }) == w.begin() + p);
+        REQUIRE(auMinElement(w.begin(), w.end()) == w.begin() + p);
+        REQUIRE(auMinElement(w.data(), w.data() + n) == w.data() + p);
+
+        // the first of two equal minimums
+        w[n - 1] = T(0);
+        REQUIRE(auMinElement(w.begin(), w.end()) == w.begin() + p);
+    }
+
+    vector<T> reversed(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        reversed[i] = T(n - i);
+    }
+    REQUIRE(auMinElement(reversed.begin(), reversed.end()) == min_element(reversed.begin(), reversed.end()));
+
+    vector<T> same(n, T(5));
+    REQUIRE(auMinElement(same.begin(), same.end()) == same.begin());
+    REQUIRE(auFind(same.begin(), same.end(), T(5)) == same.begin());
+    REQUIRE(auFind(same.begin(), same.end(), T(6)) == same.end());
+}
+
+TEST_CASE("auFind, auFindIf and auMinElement match the std algorithms")
+{
+    for (size_t n : SIZES)
+    {
+        checkSearches<int>(n);
+        checkSearches<unsigned>(n);
+        checkSearches<long long>(n);
+        checkSearches<short>(n);
+        checkSearches<double>(n);
+
+        list<int> l;
+        for (size_t i = 0; i < n; i++)
+        {
+            l.push_back(int(n - i));
+        }
+        REQUIRE(auMinElement(l.begin(), l.end()) == min_element(l.begin(), l.end()));
+        REQUIRE(auFind(l.begin(), l.end(), 1) == find(l.begin(), l.end(), 1));
+        REQUIRE(auFindIf(l.begin(), l.end(), [](int x)
+                         { return x % 7 == 0; }) == find_if(l.begin(), l.end(), [](int x)
+                                                            { return x % 7 == 0; }));
+    }
+
+    // the key converts to the element type the way std::find compares it
+    vector<int> v = {3, 1, 4};
+    REQUIRE(auFind(v.begin(), v.end(), 4.0) == v.begin() + 2);
+    REQUIRE(auFind(v.begin(), v.end(), 4.5) == v.end());
+}
+
+TEST_CASE("auFindIf stops at the first match")
+{
+    vector<int> v(4097, 0);
+    v[40] = 1;
+    v[50] = 1;
+
+    size_t calls = 0;
+    auto it = auFindIf(v.begin(), v.end(), [&calls](int x)
+                       {
+                           calls++;
+                           return x == 1;
+                       });
+
+    REQUIRE(it == v.begin() + 40);
+    REQUIRE(calls == 41);
+}
+
+TEST_CASE("auMinElement with a predicate matches std::min_element")
+{
+    for (size_t n : SIZES)
+    {
+        CAPTURE(n);
+        vector<int> v;
+        for (size_t i = 0; i < n; i++)
+        {
+            v.push_back(int(i % 10));
+        }
+
+        auto greater = [](int a, int b)
+        { return a > b; };
+        REQUIRE(auMinElement(v.begin(), v.end(), greater) == min_element(v.begin(), v.end(), greater));
+    }
+}
+
+TEST_CASE("AuParallel overloads match the std algorithms")
+{
+    const size_t GRAIN = AuParallel::GRAIN;
+    const size_t sizes[] = {0, 1, 4097, 2 * GRAIN - 1, 2 * GRAIN, 5 * GRAIN + 3};
+
+    for (unsigned threads : {1u, 3u, 8u})
+    {
+        AuParallel policy(threads);
+        CAPTURE(threads);
+
+        for (size_t n : sizes)
+        {
+            CAPTURE(n);
+            vector<int> v(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                v[i] = int(n - i % 1000);
+            }
+
+            for (size_t p : {size_t(0), GRAIN - 1, GRAIN, GRAIN + 1, n / 2, n - 1})
+            {
+                if (p >= n)
+                {
+                    continue;
+                }
+
+                CAPTURE(p);
+                vector<int> w(v);
+                w[p] = -1;
+                w[n - 1] = -1;
+
+                REQUIRE(auFind(policy, w.begin(), w.end(), -1) == w.begin() + p);
+                REQUIRE(auFindIf(policy, w.begin(), w.end(), [](int x)
+                                 { return x < 0; }) == w.begin() + p);
+                REQUIRE(auMinElement(policy, w.begin(), w.end()) == w.begin() + p);
+                REQUIRE(auMinElement(policy, w.begin(), w.end(), [](int a, int b)
+                                     { return a < b; }) == w.begin() + p);
+            }
+
+            REQUIRE(auFind(policy, v.begin(), v.end(), -1) == v.end());
+            REQUIRE(auMinElement(policy, v.begin(), v.end()) == min_element(v.begin(), v.end()));
+
+            vector<int> r(v);
+            auReverse(policy, r.begin(), r.end());
+            reverse(v.begin(), v.end());
+            REQUIRE(r == v);
+        }
+    }
+
+    list<int> l = {5, 3, 8, 3};
+    AuParallel policy(4);
+    REQUIRE(auFind(policy, l.begin(), l.end(), 8) == next(l.begin(), 2));
+    REQUIRE(auMinElement(policy, l.begin(), l.end()) == next(l.begin()));
+    auReverse(policy, l.begin(), l.end());
+    REQUIRE(l == list<int>({3, 8, 3, 5}));
+}
+
+TEST_CASE("AuParallel overloads rethrow exceptions from the predicate")
+{
+    vector<int> v(4 * AuParallel::GRAIN, 0);
+    v.back() = 1;
+
+    REQUIRE_THROWS_AS(auFindIf(AuParallel(4), v.begin(), v.end(), [](int x) -> bool
+                               {
+                                   if (x == 1)
+                                   {
+                                       throw runtime_error("one");
+                                   }
+                                   return false;
+                               }),
+                      runtime_error);
+}
+
+template <typename T, typename Compare>
+void checkSort(vector<T> v, Compare comp)
+{
+    vector<T> expected(v);
+    sort(expected.begin(), expected.end(), comp);
+
+    auSort(v.begin(), v.end(), comp);
+    REQUIRE(v == expected);
+}
+
+TEST_CASE("auSort matches std::sort")
+{
+    mt19937 rng(2024);
+
+    for (size_t n : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(24), size_t(25), size_t(31),
+                     size_t(32), size_t(33), size_t(128), size_t(4095), size_t(4096), size_t(4097), size_t(10000)})
+    {
+        CAPTURE(n);
+        vector<int> random(n), few(n), sorted(n), reversed(n), pipe(n), same(n, 7);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            random[i] = int(rng());
+            few[i] = int(rng() % 4);
+            sorted[i] = int(i);
+            reversed[i] = int(n - i);
+            pipe[i] = int(i < n / 2 ? i : n - i);
+        }
+
+        // sorted but for one element, which defeats the up-front check
+        vector<int> nearlySorted(sorted);
+        if (n > 1)
+        {
+            nearlySorted[n / 2] = -1;
+        }
+
+        for (const vector<int> *v : {&random, &few, &sorted, &reversed, &pipe, &same, &nearlySorted})
+        {
+            checkSort(*v, less<int>());
+            checkSort(*v, greater<int>());
+        }
+
+        vector<string> words(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            words[i] = to_string(rng() % 1000);
+        }
+        checkSort(words, less<string>());
+    }
+
+    int a[] = {3, 1, 2};
+    auSort(a, a + 3);
+    REQUIRE(a[0] == 1);
+    REQUIRE(a[1] == 2);
+    REQUIRE(a[2] == 3);
+}
+
+template <bool Branchless>
+void checkFallbacks(const vector<int> &v)
+{
+    vector<int> expected(v);
+    sort(expected.begin(), expected.end());
+    less<int> comp;
+
+    // with one bad partition allowed, the first unbalanced partition
+    // hands the range to heapSort
+    vector<int> w(v);
+    au_detail::pdqSort<vector<int>::iterator, less<int>, Branchless>(w.begin(), w.end(), comp, 1, true);
+    REQUIRE(w == expected);
+
+    w = v;
+    au_detail::heapSort(w.begin(), w.end(), comp);
+    REQUIRE(w == expected);
+}
+
+TEST_CASE("auSort fallbacks sort correctly")
+{
+    mt19937 rng(7);
+
+    for (size_t n : {size_t(0), size_t(1), size_t(2), size_t(23), size_t(24), size_t(25), size_t(128),
+                     size_t(129), size_t(4096), size_t(4097)})
+    {
+        CAPTURE(n);
+        vector<int> random(n), few(n), sorted(n), reversed(n), same(n, 7);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            random[i] = int(rng());
+            few[i] = int(rng() % 2);
+            sorted[i] = int(i);
+            reversed[i] = int(n - i);
+        }
+
+        // pdqSort called directly, bypassing auSort's sorted and reversed
+        // check; an all-equal range always partitions unbalanced
+        for (const vector<int> *v : {&random, &few, &sorted, &reversed, &same})
+        {
+            checkFallbacks<false>(*v);
+            checkFallbacks<true>(*v);
+        }
+    }
+}
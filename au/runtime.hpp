@@ -0,0 +1,135 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Run-time support shared by algol.hpp and BigInt.hpp.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AU_X86_KERNELS
+#endif
+
+namespace au_detail
+{
+#ifdef AU_X86_KERNELS
+    // Whether the CPU running the program has AVX2, probed once.
+    inline bool hasAvx2()
+    {
+        static const bool supported = []
+        {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+        }();
+
+        return supported;
+    }
+#endif
+
+    // Fixed set of worker threads fed from one queue. A thread waiting for
+    // its own tasks runs queued ones meanwhile, so tasks that split their
+    // work across the pool in turn cannot starve it.
+    class ThreadPool
+    {
+        std::mutex mMutex;
+        std::condition_variable mWake;
+        std::condition_variable mProgress;
+        std::deque<std::function<void()>> mQueue;
+        std::vector<std::thread> mWorkers;
+        bool mStopping;
+
+        void work()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mWake.wait(lock, [this]
+                               { return mStopping || !mQueue.empty(); });
+
+                    if (mQueue.empty())
+                    {
+                        return;
+                    }
+
+                    task = std::move(mQueue.front());
+                    mQueue.pop_front();
+                }
+
+                task();
+            }
+        }
+
+    public:
+        explicit ThreadPool(unsigned workers) : mStopping(false)
+        {
+            for (unsigned i = 0; i < workers; i++)
+            {
+                mWorkers.emplace_back([this]
+                                      { work(); });
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopping = true;
+            }
+            mWake.notify_all();
+
+            for (auto &t : mWorkers)
+            {
+                t.join();
+            }
+        }
+
+        void submit(std::function<void()> task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mQueue.push_back(std::move(task));
+            }
+            mWake.notify_one();
+            mProgress.notify_all();
+        }
+
+        // Marks one of a group's tasks as finished.
+        void finish(std::size_t &pending)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                pending--;
+            }
+            mProgress.notify_all();
+        }
+
+        // Runs queued tasks on the calling thread, or sleeps while there are
+        // none, until pending drops to zero.
+        void wait(const std::size_t &pending)
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+
+            while (pending > 0)
+            {
+                if (mQueue.empty())
+                {
+                    mProgress.wait(lock);
+                    continue;
+                }
+
+                std::function<void()> task = std::move(mQueue.front());
+                mQueue.pop_front();
+
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        }
+    };
+}
@@ -3,6 +3,25 @@
 #include <iostream>
 #include <stdexcept>
 
+namespace rational_detail
+{
+    // Euclid's algorithm on non-negative values. Types with a faster gcd
+    // (e.g. BigInt) provide a gcd overload that argument-dependent lookup
+    // prefers over this one.
+    template <typename T>
+    T gcd(T a, T b)
+    {
+        while (b != 0)
+        {
+            T r = a % b;
+            a = b;
+            b = r;
+        }
+
+        return a;
+    }
+}
+
 template <typename T>
 class Rational
 {
@@ -23,15 +42,8 @@ public:
             throw std::runtime_error("Rational: denominator cannot be equal to zero");
         }
 
-        T a = m_num < 0 ? -m_num : m_num;
-        T b = m_den < 0 ? -m_den : m_den;
-
-        while (b != 0)
-        {
-            T r = a % b;
-            a = b;
-            b = r;
-        }
+        using rational_detail::gcd;
+        T a = gcd(m_num < 0 ? -m_num : m_num, m_den < 0 ? -m_den : m_den);
 
         m_num /= a;
         m_den /= a;
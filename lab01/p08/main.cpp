@@ -5,6 +5,7 @@
 #include <sstream>
 
 #include "Rational.hpp"
+#include "../../project01/BigInt/BigInt.hpp"
 
 using namespace std;
 
@@ -247,4 +248,16 @@ TEST_CASE("Rational: input operator")
         REQUIRE(r.num() == 0);
         REQUIRE(r.den() == 1);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Rational<BigInt>")
+{
+    BigInt big("123456789012345678901234567890123456789");
+    Rational<BigInt> r(big * BigInt("-98765432109876543210"), big * 30);
+
+    REQUIRE(r.num() == BigInt("-3292181070329218107"));
+    REQUIRE(r.den() == 1);
+
+    Rational<BigInt> half(1, 2);
+    REQUIRE(r + half == Rational<BigInt>(BigInt("-6584362140658436213"), 2));
+}
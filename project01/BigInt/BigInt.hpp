@@ -1,10 +1,30 @@
 #pragma once
 
 #include <vector>
+#include <map>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <stdexcept>
 #include <algorithm>
+#include <utility>
+#include <iterator>
+#include <cstdint>
+#include <cctype>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <cstring>
+
+#include "../../au/runtime.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BIGINT_X86_KERNELS
+#include <immintrin.h>
+#endif
 
 class BigInt
 {
@@ -21,787 +41,3411 @@ class BigInt
     friend BigInt operator*(const BigInt &, const BigInt &);
     friend BigInt operator/(const BigInt &, const BigInt &);
     friend BigInt operator%(const BigInt &, const BigInt &);
-    friend BigInt operator++(const BigInt &, int);
-    friend BigInt &operator++(const BigInt &);
-    friend BigInt operator--(const BigInt &, int);
-    friend BigInt &operator--(const BigInt &);
+    friend BigInt operator++(BigInt &, int);
+    friend BigInt &operator++(BigInt &);
+    friend BigInt operator--(BigInt &, int);
+    friend BigInt &operator--(BigInt &);
     friend BigInt &operator+=(BigInt &, const BigInt &);
     friend BigInt &operator-=(BigInt &, const BigInt &);
     friend BigInt &operator*=(BigInt &, const BigInt &);
     friend BigInt &operator/=(BigInt &, const BigInt &);
     friend BigInt &operator%=(BigInt &, const BigInt &);
-    friend BigInt operator+(const BigInt);
-    friend BigInt operator-(const BigInt);
-
-    std::vector<int> mDigits;
-    bool mIsNegative;
+    friend BigInt operator+(BigInt);
+    friend BigInt operator-(BigInt);
+    friend bool operator==(const BigInt &, long long);
+    friend bool operator!=(const BigInt &, long long);
+    friend bool operator<(const BigInt &, long long);
+    friend bool operator>(const BigInt &, long long);
+    friend bool operator<=(const BigInt &, long long);
+    friend bool operator>=(const BigInt &, long long);
+    friend bool operator==(long long, const BigInt &);
+    friend bool operator!=(long long, const BigInt &);
+    friend bool operator<(long long, const BigInt &);
+    friend bool operator>(long long, const BigInt &);
+    friend bool operator<=(long long, const BigInt &);
+    friend bool operator>=(long long, const BigInt &);
+    friend BigInt operator+(const BigInt &, long long);
+    friend BigInt operator+(long long, const BigInt &);
+    friend BigInt operator-(const BigInt &, long long);
+    friend BigInt operator-(long long, const BigInt &);
+    friend BigInt operator*(const BigInt &, long long);
+    friend BigInt operator*(long long, const BigInt &);
+    friend BigInt operator/(const BigInt &, long long);
+    friend BigInt operator%(const BigInt &, long long);
+    friend BigInt &operator+=(BigInt &, long long);
+    friend BigInt &operator-=(BigInt &, long long);
+    friend BigInt &operator*=(BigInt &, long long);
+    friend BigInt &operator/=(BigInt &, long long);
+    friend BigInt &operator%=(BigInt &, long long);
 
 public:
-    static BigInt abs(const BigInt &);
+    // Each limb holds 9 decimal digits, least significant limb first.
+    // Zero has no limbs and is never negative.
+    typedef std::uint32_t Limb;
+    typedef std::uint64_t DoubleLimb;
 
-    BigInt() : mIsNegative(false)
-    {
-        mDigits.push_back(0);
-    }
+    static const Limb BASE = 1000000000;
+    static const int BASE_DIGITS = 9;
 
-    BigInt(const std::string &s) : mIsNegative(false)
+    // Limb storage traffic of one thread, as reported by allocationStats.
+    struct AllocationStats
     {
-        if (s.empty())
-        {
-            mDigits.push_back(0);
-            throw std::runtime_error("invalid representation of BigInt value");
-        }
-        else
+        // blocks handed to values, whether reused or fresh
+        unsigned long long allocations;
+        // blocks that had to come from operator new
+        unsigned long long heapAllocations;
+        // blocks given back to operator delete
+        unsigned long long heapFrees;
+    };
+
+private:
+    // Per-thread cache of limb blocks. Blocks of up to MAX_POOLED_LIMBS
+    // limbs are rounded up to a power of two and, once released, kept on
+    // a free list of their size class for the next value of that size,
+    // so the temporaries of division, gcd and powering loops recycle each
+    // other's storage instead of going through the heap. A block may be
+    // released on another thread than the one it came from; it then joins
+    // that thread's cache.
+    class LimbPool
+    {
+    public:
+        static const std::size_t MIN_POOLED_LIMBS = 8;
+        static const std::size_t MAX_POOLED_LIMBS = std::size_t(1) << 16;
+        static const std::size_t MAX_CACHED_BLOCKS = 8;
+
+        // Returns storage for at least capacity limbs and sets capacity to
+        // what the block can actually hold.
+        static Limb *allocate(std::size_t &capacity)
         {
-            std::string s_copy = s;
+            Cache *cache = threadCache();
+            std::size_t sizeClass = 0;
 
-            while (s_copy.size() > 1 && s_copy.front() == '0')
+            if (capacity <= MAX_POOLED_LIMBS)
             {
-                s_copy.erase(s_copy.begin());
+                while ((MIN_POOLED_LIMBS << sizeClass) < capacity)
+                {
+                    sizeClass++;
+                }
+                capacity = MIN_POOLED_LIMBS << sizeClass;
+
+                if (cache != nullptr && cache->counts[sizeClass] != 0)
+                {
+                    Block *block = cache->heads[sizeClass];
+                    cache->heads[sizeClass] = block->next;
+                    cache->counts[sizeClass]--;
+                    cache->stats.allocations++;
+                    return reinterpret_cast<Limb *>(block);
+                }
             }
 
-            std::istringstream in(s_copy);
-            char ch;
+            Limb *data = static_cast<Limb *>(::operator new(capacity * sizeof(Limb)));
 
-            while (!(in >> ch))
+            if (cache != nullptr)
             {
-                continue;
+                cache->stats.allocations++;
+                cache->stats.heapAllocations++;
             }
 
-            in.putback(ch);
+            return data;
+        }
 
-            std::string n;
+        static void release(Limb *data, std::size_t capacity)
+        {
+            Cache *cache = threadCache();
 
-            while (in >> ch)
+            if (cache != nullptr && capacity <= MAX_POOLED_LIMBS)
             {
-                if ((ch == '+' || ch == '-') && !std::isdigit(in.peek()))
-                {
-                    mDigits.push_back(0);
-                    throw std::runtime_error("invalid representation of BigInt value");
-                }
-
-                if (!(std::isdigit(ch) || ch == '+' || ch == '-'))
-                {
-                    mDigits.push_back(0);
-                    in.putback(ch);
-                    throw std::runtime_error("invalid representation of BigInt value");
-                }
-
-                if (std::isdigit(ch) || ch == '-')
-                {
-                    n += ch;
-                }
-
-                while (in.get(ch) && std::isdigit(ch))
+                std::size_t sizeClass = 0;
+                while ((MIN_POOLED_LIMBS << sizeClass) < capacity)
                 {
-                    n += ch;
+                    sizeClass++;
                 }
 
-                if (!std::isdigit(ch))
+                if (cache->counts[sizeClass] < MAX_CACHED_BLOCKS)
                 {
-                    in.putback(ch);
-                    break;
+                    Block *block = reinterpret_cast<Block *>(data);
+                    block->next = cache->heads[sizeClass];
+                    cache->heads[sizeClass] = block;
+                    cache->counts[sizeClass]++;
+                    return;
                 }
             }
 
-            mIsNegative = (n[0] == '-');
+            ::operator delete(data);
 
-            for (int i = (mIsNegative ? 1 : 0); i < (int)n.size(); i++)
+            if (cache != nullptr)
             {
-                auto d = n[i];
-
-                if (!std::isdigit(d))
-                    throw std::runtime_error("invalid representation of BigInt value");
-
-                mDigits.push_back(d - '0');
+                cache->stats.heapFrees++;
             }
         }
-    }
-
-    BigInt(const long long val) : BigInt(std::to_string(val)) {}
-
-    static BigInt addAbsValues(const BigInt &a, const BigInt &b)
-    {
-        auto itA = a.mDigits.rbegin();
-        auto itB = b.mDigits.rbegin();
-
-        BigInt z;
-        z.mDigits.resize(std::max(a.mDigits.size(), b.mDigits.size()) + 1);
-        auto itZ = z.mDigits.rbegin();
 
-        int carry = 0;
-        while (itA != a.mDigits.rend() || itB != b.mDigits.rend())
+        static AllocationStats stats()
         {
-            int s = carry;
+            Cache *cache = threadCache();
+            return cache != nullptr ? cache->stats : AllocationStats();
+        }
 
-            if (itA != a.mDigits.rend())
+        static void resetStats()
+        {
+            if (Cache *cache = threadCache())
             {
-                s += *itA;
-                ++itA;
+                cache->stats = AllocationStats();
             }
+        }
 
-            if (itB != b.mDigits.rend())
+        static void trim()
+        {
+            if (Cache *cache = threadCache())
             {
-                s += *itB;
-                ++itB;
+                cache->clear();
             }
-            *itZ = s % 10;
-            carry = (s > 9) ? 1 : 0;
-            ++itZ;
-        }
-        if (carry != 0)
-        {
-            *itZ = carry;
         }
-        if (z.mDigits.size() > 1 && z.mDigits.front() == 0)
-            z.mDigits.erase(z.mDigits.begin());
-
-        return z;
-    }
 
-    static BigInt subAbsValues(const BigInt &a, const BigInt &b)
-    {
-        auto itA = a.mDigits.rbegin();
-        auto itB = b.mDigits.rbegin();
+    private:
+        static const std::size_t SIZE_CLASSES = 14;
 
-        BigInt z;
-        z.mDigits.resize(std::max(a.mDigits.size(), b.mDigits.size()));
-        auto itZ = z.mDigits.rbegin();
+        struct Block
+        {
+            Block *next;
+        };
 
-        int carry = 0;
-        while (itA != a.mDigits.rend() || itB != b.mDigits.rend())
+        struct Cache
         {
-            int a_val, b_val, s = 0;
+            Block *heads[SIZE_CLASSES];
+            std::size_t counts[SIZE_CLASSES];
+            AllocationStats stats;
 
-            if (itA != a.mDigits.rend())
+            Cache() : heads(), counts(), stats()
             {
-                s = *itA;
-                a_val = *itA;
-                ++itA;
             }
 
-            if (carry)
+            ~Cache()
             {
-                if (s > 0)
-                {
-                    s = s - 1;
-                    a_val = s;
-                    carry = 0;
-                }
-                else if (s == 0)
-                {
-                    s = 9;
-                    carry = 1;
-                }
+                clear();
+                threadExited() = true;
             }
 
-            if (itB != b.mDigits.rend())
+            void clear()
             {
-                s -= *itB;
-                b_val = *itB;
-                ++itB;
+                for (std::size_t c = 0; c < SIZE_CLASSES; c++)
+                {
+                    for (; heads[c] != nullptr; counts[c]--)
+                    {
+                        Block *next = heads[c]->next;
+                        ::operator delete(heads[c]);
+                        heads[c] = next;
+                        stats.heapFrees++;
+                    }
+                }
             }
+        };
+
+        // Set once the thread's cache is destroyed; values outliving it,
+        // such as statics freed at exit, go straight back to the heap.
+        static bool &threadExited()
+        {
+            static thread_local bool exited = false;
+            return exited;
+        }
 
-            if (s < 0)
+        static Cache *threadCache()
+        {
+            if (threadExited())
             {
-                carry = 1;
-                s = 10 + a_val - b_val;
+                return nullptr;
             }
 
-            *itZ = s;
-            ++itZ;
+            static thread_local Cache cache;
+            return &cache;
         }
+    };
 
-        while (z.mDigits.size() > 1 && z.mDigits.front() == 0)
-            z.mDigits.erase(z.mDigits.begin());
-
-        return z;
-    }
-
-    static BigInt multiplyAbsValues(const BigInt &a, const BigInt &b)
+    // Limb storage with room for INLINE_LIMBS limbs inside the object
+    // itself; it moves to the heap only once a value outgrows them, so
+    // small values never allocate.
+    class LimbBuffer
     {
-        BigInt z;
-        int n = a.mDigits.size(), m = b.mDigits.size();
-
-        std::vector<int> v(n + m, 0);
+    public:
+        static const std::size_t INLINE_LIMBS = 4;
 
-        int i = 0;
-
-        for (auto itA = a.mDigits.rbegin(); itA != a.mDigits.rend(); itA++, i++)
+        LimbBuffer() : mData(mInline), mSize(0), mCapacity(INLINE_LIMBS)
         {
-            int j = 0;
-
-            for (auto itB = b.mDigits.rbegin(); itB != b.mDigits.rend(); itB++, j++)
-                v[i + j] += (*itA) * (*itB);
         }
 
-        n += m;
-        z.mDigits.resize(v.size());
-
-        auto itZ = z.mDigits.rbegin();
-
-        for (int s, i = 0, t = 0; i < n && itZ != z.mDigits.rend(); i++, itZ++)
+        LimbBuffer(const LimbBuffer &other) : LimbBuffer()
         {
-            s = t + v[i];
-            v[i] = s % 10;
-            t = s / 10;
-            *itZ = v[i];
+            assign(other.begin(), other.end());
         }
 
-        while (z.mDigits.size() > 1 && z.mDigits.front() == 0)
+        LimbBuffer(LimbBuffer &&other) noexcept : LimbBuffer()
         {
-            z.mDigits.erase(z.mDigits.begin());
+            steal(other);
         }
 
-        return z;
-        // auto itA = a.mDigits.rbegin();
-        // auto itB = b.mDigits.rbegin();
-
-        // BigInt z, r(0);
-
-        // int carry = 0, a_val, b_val, s, cnt = 0;
-
-        // while (itB != b.mDigits.rend() || itA != a.mDigits.rend())
-        // {
-        //     if (itB != b.mDigits.rend())
-        //     {
-        //         b_val = *itB;
-        //         ++itB;
-        //     }
+        ~LimbBuffer()
+        {
+            release();
+        }
 
-        //     z.mDigits.clear();
-        //     z.mDigits.resize(std::max(a.mDigits.size(), b.mDigits.size()) + 1);
+        LimbBuffer &operator=(const LimbBuffer &other)
+        {
+            if (this != &other)
+            {
+                assign(other.begin(), other.end());
+            }
 
-        //     auto itZ = z.mDigits.rbegin();
-        //     itA = a.mDigits.rbegin();
+            return *this;
+        }
 
-        //     s = 0;
-        //     carry = 0;
+        LimbBuffer &operator=(LimbBuffer &&other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                mData = mInline;
+                mSize = 0;
+                mCapacity = INLINE_LIMBS;
+                steal(other);
+            }
 
-        //     while (itA != a.mDigits.rend())
-        //     {
-        //         if (itA != a.mDigits.rend())
-        //         {
-        //             a_val = *itA;
-        //             ++itA;
-        //         }
+            return *this;
+        }
 
-        //         s = a_val * b_val + carry;
+        std::size_t size() const { return mSize; }
+        std::size_t capacity() const { return mCapacity; }
+        bool empty() const { return mSize == 0; }
+        bool isInline() const { return mData == mInline; }
 
-        //         if (s >= 10)
-        //             carry = s / 10;
-        //         else
-        //             carry = 0;
+        Limb *begin() { return mData; }
+        Limb *end() { return mData + mSize; }
+        const Limb *begin() const { return mData; }
+        const Limb *end() const { return mData + mSize; }
 
-        //         *itZ = s % 10;
-        //         ++itZ;
-        //     }
+        Limb &operator[](std::size_t i) { return mData[i]; }
+        const Limb &operator[](std::size_t i) const { return mData[i]; }
+        Limb &back() { return mData[mSize - 1]; }
+        const Limb &back() const { return mData[mSize - 1]; }
 
-        //     if (carry != 0)
-        //     {
-        //         *itZ = carry;
-        //     }
-        //     while (z.mDigits.size() > 1 && z.mDigits.front() == 0)
-        //     {
-        //         z.mDigits.erase(z.mDigits.begin());
-        //     }
-        //     for (int i = 0; i < cnt; i++)
-        //     {
-        //         z.mDigits.insert(z.mDigits.end(), 0);
-        //     }
-        //     r += z;
+        void reserve(std::size_t n)
+        {
+            if (n <= mCapacity)
+            {
+                return;
+            }
 
-        //     cnt++;
-        // }
+            Limb *data = LimbPool::allocate(n);
+            std::copy(mData, mData + mSize, data);
+            release();
+            mData = data;
+            mCapacity = n;
+        }
 
-        // return r;
-    }
+        void resize(std::size_t n, Limb value = 0)
+        {
+            if (n > mSize)
+            {
+                grow(n);
+                std::fill(mData + mSize, mData + n, value);
+            }
 
-    static BigInt divideAbsValues(const BigInt &a, const BigInt &b)
-    {
-        BigInt t, z, copy_a;
+            mSize = n;
+        }
 
-        copy_a = a;
+        void assign(std::size_t n, Limb value)
+        {
+            mSize = 0;
+            resize(n, value);
+        }
 
-        reverse(begin(copy_a.mDigits), end(copy_a.mDigits));
+        void assign(const Limb *first, const Limb *last)
+        {
+            std::size_t n = std::size_t(last - first);
+            mSize = 0;
+            grow(n);
+            std::copy(first, last, mData);
+            mSize = n;
+        }
 
-        int i, lgcat = 0, cc, n = copy_a.mDigits.size(), m = b.mDigits.size();
+        void push_back(Limb value)
+        {
+            grow(mSize + 1);
+            mData[mSize++] = value;
+        }
 
-        std::vector<int> cat(n, 0);
+        void pop_back()
+        {
+            mSize--;
+        }
 
-        for (i = n - 1; t * 10 + copy_a.mDigits[i] < b; i--)
+        void clear()
         {
-            t *= 10;
-            t += copy_a.mDigits[i];
+            mSize = 0;
         }
 
-        for (; i >= 0; i--)
+        void swap(LimbBuffer &other)
         {
-            t = t * 10 + copy_a.mDigits[i];
-            for (cc = 9; cc * b > t; cc--)
-                ;
-            t -= cc * b;
-            cat[lgcat++] = cc;
+            LimbBuffer t(std::move(other));
+            other = std::move(*this);
+            *this = std::move(t);
         }
 
-        z.mDigits.resize(cat.size());
+    private:
+        Limb *mData;
+        std::size_t mSize;
+        std::size_t mCapacity;
+        Limb mInline[INLINE_LIMBS];
 
-        for (i = 0; i < lgcat; i++)
-            z.mDigits[i] = cat[lgcat - i - 1];
+        void release()
+        {
+            if (!isInline())
+            {
+                LimbPool::release(mData, mCapacity);
+            }
+        }
 
-        z.mDigits.resize(lgcat);
+        void grow(std::size_t n)
+        {
+            if (n > mCapacity)
+            {
+                reserve(std::max(n, 2 * mCapacity));
+            }
+        }
 
-        reverse(begin(z.mDigits), end(z.mDigits));
+        // takes over the contents of other, which must not alias *this and
+        // is left empty; *this must be empty and inline
+        void steal(LimbBuffer &other)
+        {
+            if (other.isInline())
+            {
+                std::copy(other.mData, other.mData + other.mSize, mInline);
+            }
+            else
+            {
+                mData = other.mData;
+                mCapacity = other.mCapacity;
+                other.mData = other.mInline;
+                other.mCapacity = INLINE_LIMBS;
+            }
 
-        return z;
+            mSize = other.mSize;
+            other.mSize = 0;
+        }
+    };
 
-        // r.mDigits.clear();
-        // z.mDigits.clear();
-
-        /* auto itA = a.mDigits.begin();
-
-         while (itA != a.mDigits.end())
-         {
-           while (z < b && itA != a.mDigits.end())
-           {
-             z.mDigits.push_back(*itA);
-             itA++;
-           }
-
-           if (z.mDigits.front() == 0)
-           {
-             z.mDigits.erase(z.mDigits.begin());
-           }
-
-           long cnt = 0;
-
-           while (b * (cnt + 1) <= z)
-             cnt++;
-
-           p = b * cnt;
-
-           //if (cnt > 0)
-           r.mDigits.push_back(cnt);
-
-           if (p == z)
-           {
-             if (itA != a.mDigits.end() && *itA != 0)
-             {
-               r.mDigits.push_back(0);
-             }
-             else
-             {
-               while (itA != a.mDigits.end() && *itA == 0)
-               {
-                 r.mDigits.push_back(0);
-                 itA++;
-               }
-               if (itA != a.mDigits.end())
-               {
-                 r.mDigits.push_back(0);
-               }
-             }
-           }
-
-           z -= p;
-         }
-         while (r.mDigits.size() > 1 && r.mDigits.front() == 0)
-         {
-           r.mDigits.erase(r.mDigits.begin());
-         }
-         return r;*/
-    }
+    LimbBuffer mLimbs;
+    bool mIsNegative;
 
-    static BigInt modDivideAbsValues(const BigInt &a, const BigInt &b)
+    void normalize()
     {
-        return a - b * (a / b);
-    }
-};
+        while (!mLimbs.empty() && mLimbs.back() == 0)
+        {
+            mLimbs.pop_back();
+        }
 
-inline std::ostream &operator<<(std::ostream &out, const BigInt &x)
-{
-    if (x.mIsNegative) /*&& x > 0)*/
-    {
-        out << "-";
-    }
-    for (auto d : x.mDigits)
-    {
-        out << d;
+        if (mLimbs.empty())
+        {
+            mIsNegative = false;
+        }
     }
-    return out;
-}
 
-inline std::istream &operator>>(std::istream &in, BigInt &x)
-{
-    char ch;
+    // Operand sizes, in limbs, below which a multiplication tier falls back
+    // to the simpler one.
+    static const std::size_t KARATSUBA_THRESHOLD = 48;
+    static const std::size_t TOOM3_THRESHOLD = 400;
+    static const std::size_t NTT_THRESHOLD = 1500;
 
-    if (!(in >> ch))
-    {
-        return in;
-    }
+    // Longest product the three-prime NTT can represent (2^23 limbs).
+    static const std::size_t NTT_MAX_LIMBS = std::size_t(1) << 23;
 
-    if ((ch == '+' || ch == '-') && !std::isdigit(in.peek()))
-    {
-        in.setstate(std::ios_base::failbit);
-        return in;
-    }
+    // Default operand size, in limbs, from which products split their work
+    // across the thread pool once setParallelism has enabled one.
+    static const std::size_t PARALLEL_THRESHOLD = 1000;
 
-    if (!(std::isdigit(ch) || ch == '+' || ch == '-'))
+    struct ParallelState
     {
-        in.putback(ch);
-        in.setstate(std::ios_base::failbit);
-        return in;
-    }
+        std::atomic<unsigned> threads;
+        std::atomic<std::size_t> minLimbs;
+        std::unique_ptr<au_detail::ThreadPool> pool;
 
-    std::string s;
+        ParallelState() : threads(1), minLimbs(PARALLEL_THRESHOLD)
+        {
+        }
+    };
 
-    if (std::isdigit(ch) || ch == '-')
+    static ParallelState &parallelState()
     {
-        s += ch;
+        static ParallelState state;
+        return state;
     }
 
-    while (in.get(ch) && std::isdigit(ch))
+    static bool runsParallel(std::size_t limbs)
     {
-        s += ch;
+        const ParallelState &state = parallelState();
+        return state.threads > 1 && limbs >= state.minLimbs;
     }
 
-    x = BigInt(s);
-
-    if (!std::isdigit(ch))
+    // Runs every task, the first on the calling thread and the rest on the
+    // pool, and returns when all are done. Rethrows the first exception.
+    static void parallelInvoke(const std::vector<std::function<void()>> &tasks)
     {
-        in.putback(ch);
-        return in;
-    }
-
-    return in;
-}
-
-inline bool operator==(const BigInt &a, const BigInt &b)
-{
-    return a.mIsNegative == b.mIsNegative && a.mDigits == b.mDigits;
-}
-
-inline bool operator!=(const BigInt &a, const BigInt &b)
-{
-    return !(a == b);
-}
-
-inline bool operator<(const BigInt &a, const BigInt &b)
-{
-    if (a.mIsNegative && !b.mIsNegative)
-        return true;
-
-    if (!(a.mIsNegative || b.mIsNegative) && a.mDigits.size() < b.mDigits.size())
-        return true;
-
-    if (a.mIsNegative && b.mIsNegative && a.mDigits.size() > b.mDigits.size())
-        return true;
-
-    if (a.mIsNegative && b.mIsNegative && a.mDigits > b.mDigits && a.mDigits.size() == b.mDigits.size())
-        return true;
-
-    if (!(a.mIsNegative || b.mIsNegative) && a.mDigits < b.mDigits && a.mDigits.size() == b.mDigits.size())
-        return true;
-
-    return false;
-}
-
-inline bool operator>(const BigInt &a, const BigInt &b)
-{
-    return b < a;
-}
+        std::vector<std::exception_ptr> errors(tasks.size());
+        au_detail::ThreadPool *pool = parallelState().pool.get();
 
-inline bool operator>=(const BigInt &a, const BigInt &b)
-{
-    return !(a < b);
-}
+        auto run = [&tasks, &errors](std::size_t i)
+        {
+            try
+            {
+                tasks[i]();
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        };
 
-inline bool operator<=(const BigInt &a, const BigInt &b)
-{
-    return !(b < a);
-}
+        if (pool == nullptr || tasks.size() < 2)
+        {
+            for (std::size_t i = 0; i < tasks.size(); i++)
+            {
+                run(i);
+            }
+        }
+        else
+        {
+            // guarded by the pool's mutex
+            std::size_t pending = tasks.size() - 1;
 
-inline BigInt BigInt::abs(const BigInt &x)
-{
-    BigInt r = x;
-    if (r.mIsNegative)
-        r.mIsNegative = false;
-    return r;
-}
+            for (std::size_t i = 1; i < tasks.size(); i++)
+            {
+                pool->submit([&run, &pending, pool, i]
+                             {
+                                 run(i);
+                                 pool->finish(pending);
+                             });
+            }
 
-inline BigInt operator+(const BigInt &a, const BigInt &b)
-{
-    BigInt r(0);
+            run(0);
+            pool->wait(pending);
+        }
 
-    if (!a.mIsNegative && !b.mIsNegative)
-    {
-        return BigInt::addAbsValues(a, b);
+        for (auto &e : errors)
+        {
+            if (e)
+            {
+                std::rethrow_exception(e);
+            }
+        }
     }
 
-    if (a.mIsNegative && b.mIsNegative)
+    // body(lo, hi) over [0, count) in up to one range per configured
+    // thread, none shorter than grain.
+    static void parallelFor(std::size_t count, std::size_t grain,
+                            const std::function<void(std::size_t, std::size_t)> &body)
     {
-        r = BigInt::addAbsValues(a, b);
-        r.mIsNegative = true;
-        return r;
-    }
+        std::size_t parts = std::min<std::size_t>(parallelState().threads, count / std::max<std::size_t>(grain, 1));
 
-    if (a.mIsNegative && !b.mIsNegative)
-    {
-        if (BigInt::abs(a) > b)
+        if (parts <= 1)
         {
-            r = BigInt::subAbsValues(a, b);
-            r.mIsNegative = true;
-            return r;
+            body(0, count);
+            return;
         }
-        if (BigInt::abs(a) < b)
+
+        std::vector<std::function<void()>> tasks;
+        for (std::size_t p = 0; p < parts; p++)
         {
-            return BigInt::subAbsValues(b, a);
+            std::size_t lo = count * p / parts, hi = count * (p + 1) / parts;
+            tasks.push_back([&body, lo, hi]
+                            { body(lo, hi); });
         }
+
+        parallelInvoke(tasks);
     }
 
-    if (!a.mIsNegative && b.mIsNegative)
+    // |x| *= m, in place.
+    static void multiplyAbsSmall(BigInt &x, Limb m)
     {
-        if (a > BigInt::abs(b))
+        if (m == 0)
         {
-            return BigInt::subAbsValues(a, b);
+            x.mLimbs.clear();
+            x.mIsNegative = false;
+            return;
         }
 
-        if (a < BigInt::abs(b))
+        DoubleLimb carry = 0;
+        for (std::size_t i = 0; i < x.mLimbs.size(); i++)
         {
-            r = BigInt::subAbsValues(b, a);
-            r.mIsNegative = true;
-            return r;
+            DoubleLimb cur = DoubleLimb(x.mLimbs[i]) * m + carry;
+            x.mLimbs[i] = Limb(cur % BASE);
+            carry = cur / BASE;
         }
-    }
-
-    return r;
-}
 
-inline BigInt operator-(const BigInt &a, const BigInt &b)
-{
-    BigInt r(0);
+        if (carry != 0)
+        {
+            x.mLimbs.push_back(Limb(carry));
+        }
+    }
 
-    if (!a.mIsNegative && !b.mIsNegative)
+    // |x| /= d, in place; returns the remainder.
+    static Limb divideAbsSmall(BigInt &x, Limb d)
     {
-        if (a < b)
+        DoubleLimb cur = 0;
+        for (std::size_t i = x.mLimbs.size(); i-- > 0;)
         {
-            r = BigInt::subAbsValues(b, a);
-            r.mIsNegative = true;
-            return r;
+            cur = cur % d * BASE + x.mLimbs[i];
+            x.mLimbs[i] = Limb(cur / d);
         }
 
-        return BigInt::subAbsValues(a, b);
+        x.normalize();
+        return Limb(cur % d);
     }
 
-    if (a.mIsNegative && b.mIsNegative)
+    static Limb modAbsSmall(const BigInt &x, Limb d)
     {
-        if (BigInt::abs(a) > BigInt::abs(b))
+        DoubleLimb rem = 0;
+        for (std::size_t i = x.mLimbs.size(); i-- > 0;)
         {
-            r = BigInt::subAbsValues(BigInt::abs(a), BigInt::abs(b));
-            r.mIsNegative = true;
-            return r;
+            rem = (rem * BASE + x.mLimbs[i]) % d;
         }
 
-        if (BigInt::abs(b) > BigInt::abs(a))
+        return Limb(rem);
+    }
+
+    // |x| += v, in place.
+    static void addAbsSmall(BigInt &x, Limb v)
+    {
+        for (std::size_t i = 0; v != 0; i++)
         {
-            return BigInt::subAbsValues(BigInt::abs(b), BigInt::abs(a));
+            if (i == x.mLimbs.size())
+            {
+                x.mLimbs.push_back(0);
+            }
+
+            Limb s = x.mLimbs[i] + v;
+            v = (s >= BASE) ? 1 : 0;
+            x.mLimbs[i] = s - v * BASE;
         }
     }
 
-    if (a.mIsNegative && !b.mIsNegative)
+    // |x| -= v, in place; requires |x| >= v.
+    static void subAbsSmall(BigInt &x, Limb v)
     {
-        r = BigInt::addAbsValues(BigInt::abs(a), b);
-        r.mIsNegative = true;
+        for (std::size_t i = 0; v != 0; i++)
+        {
+            Limb s = x.mLimbs[i] + BASE - v;
+            v = (s < BASE) ? 1 : 0;
+            x.mLimbs[i] = s - (1 - v) * BASE;
+        }
+
+        x.normalize();
+    }
+
+    // x += v or x -= v for v < BASE, in place.
+    static void addSmall(BigInt &x, bool negative, Limb v)
+    {
+        if (x.mLimbs.empty() || x.mIsNegative == negative)
+        {
+            x.mIsNegative = negative;
+            addAbsSmall(x, v);
+        }
+        else if (compareAbs(x, v) >= 0)
+        {
+            subAbsSmall(x, v);
+        }
+        else
+        {
+            x.mLimbs[0] = v - x.mLimbs[0];
+            x.mIsNegative = negative;
+        }
+
+        x.normalize();
+    }
+
+    static DoubleLimb magnitude(long long v)
+    {
+        return v < 0 ? DoubleLimb(0) - DoubleLimb(v) : DoubleLimb(v);
+    }
+
+    static bool fitsInLimb(long long v)
+    {
+        return v > -(long long)BASE && v < (long long)BASE;
+    }
+
+    // Keeps the sign of a.
+    static BigInt multiplyBySmall(const BigInt &a, Limb m)
+    {
+        BigInt z = a;
+        multiplyAbsSmall(z, m);
+        return z;
+    }
+
+    // Truncating division by a single limb; keeps the sign of a.
+    static BigInt divideBySmall(const BigInt &a, Limb d)
+    {
+        Limb rem;
+        return divideBySmall(a, d, rem);
+    }
+
+    static BigInt divideBySmall(const BigInt &a, Limb d, Limb &rem)
+    {
+        BigInt z = a;
+        rem = divideAbsSmall(z, d);
+        return z;
+    }
+
+    // Limbs [from, from + len) of |a| as a new value.
+    static BigInt slice(const BigInt &a, std::size_t from, std::size_t len)
+    {
+        BigInt z;
+
+        if (from < a.mLimbs.size())
+        {
+            std::size_t to = std::min(a.mLimbs.size(), from + len);
+            z.mLimbs.assign(a.mLimbs.begin() + from, a.mLimbs.begin() + to);
+            z.normalize();
+        }
+
+        return z;
+    }
+
+    // Limb-array kernels behind every addition and subtraction: z = a + b
+    // + carry and z = a - b - borrow over n limbs, returning the carry or
+    // borrow out. z may alias a or b. On x86 the AVX2 versions are picked
+    // at run time when the CPU has it; the code is built for the baseline
+    // target either way.
+    static Limb addLimbsScalar(Limb *z, const Limb *a, const Limb *b, std::size_t n, Limb carry)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            Limb s = a[i] + b[i] + carry;
+            carry = (s >= BASE) ? 1 : 0;
+            z[i] = s - carry * BASE;
+        }
+
+        return carry;
+    }
+
+    static Limb subLimbsScalar(Limb *z, const Limb *a, const Limb *b, std::size_t n, Limb borrow)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            Limb s = a[i] + BASE - b[i] - borrow;
+            borrow = (s < BASE) ? 1 : 0;
+            z[i] = s - (1 - borrow) * BASE;
+        }
+
+        return borrow;
+    }
+
+#ifdef BIGINT_X86_KERNELS
+    // Eight limbs per step. Each lane either generates a carry (sum >=
+    // BASE), propagates one (sum == BASE - 1) or absorbs it; packing those
+    // as bit masks g and p turns the carry chain into one binary addition,
+    // since the carries into the lanes are exactly the carries of
+    // (g | p) + g + carry_in.
+    __attribute__((target("avx2"))) static Limb addLimbsAvx2(Limb *z, const Limb *a, const Limb *b, std::size_t n, Limb carry)
+    {
+        const __m256i base = _mm256_set1_epi32(int(BASE));
+        const __m256i top = _mm256_set1_epi32(int(BASE - 1));
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i one = _mm256_set1_epi32(1);
+        std::size_t i = 0;
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i s = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(a + i)),
+                                         _mm256_loadu_si256((const __m256i *)(b + i)));
+
+            unsigned g = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(s, top))));
+            unsigned p = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(s, top))));
+            unsigned c = (((g | p) + g + carry) ^ p) & 0x1ffu;
+
+            s = _mm256_add_epi32(s, _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(int(c)), lanes), one));
+            s = _mm256_sub_epi32(s, _mm256_and_si256(_mm256_cmpgt_epi32(s, top), base));
+            _mm256_storeu_si256((__m256i *)(z + i), s);
+
+            carry = c >> 8;
+        }
+
+        return addLimbsScalar(z + i, a + i, b + i, n - i, carry);
+    }
+
+    // Same scheme with borrows: a lane generates one when a < b and
+    // propagates one when a == b.
+    __attribute__((target("avx2"))) static Limb subLimbsAvx2(Limb *z, const Limb *a, const Limb *b, std::size_t n, Limb borrow)
+    {
+        const __m256i base = _mm256_set1_epi32(int(BASE));
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i one = _mm256_set1_epi32(1);
+        std::size_t i = 0;
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i d = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(a + i)),
+                                         _mm256_loadu_si256((const __m256i *)(b + i)));
+
+            unsigned g = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(zero, d))));
+            unsigned p = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(d, zero))));
+            unsigned c = (((g | p) + g + borrow) ^ p) & 0x1ffu;
+
+            d = _mm256_sub_epi32(d, _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(int(c)), lanes), one));
+            d = _mm256_add_epi32(d, _mm256_and_si256(_mm256_cmpgt_epi32(zero, d), base));
+            _mm256_storeu_si256((__m256i *)(z + i), d);
+
+            borrow = c >> 8;
+        }
+
+        return subLimbsScalar(z + i, a + i, b + i, n - i, borrow);
+    }
+#endif
+
+    // Below this many limbs the vector kernels do not pay for the dispatch.
+    static const std::size_t VECTOR_MIN_LIMBS = 16;
+
+    static Limb addLimbs(Limb *z, const Limb *a, const Limb *b, std::size_t n, Limb carry)
+    {
+#ifdef BIGINT_X86_KERNELS
+        if (n >= VECTOR_MIN_LIMBS && au_detail::hasAvx2())
+        {
+            return addLimbsAvx2(z, a, b, n, carry);
+        }
+#endif
+        return addLimbsScalar(z, a, b, n, carry);
+    }
+
+    static Limb subLimbs(Limb *z, const Limb *a, const Limb *b, std::size_t n, Limb borrow)
+    {
+#ifdef BIGINT_X86_KERNELS
+        if (n >= VECTOR_MIN_LIMBS && au_detail::hasAvx2())
+        {
+            return subLimbsAvx2(z, a, b, n, borrow);
+        }
+#endif
+        return subLimbsScalar(z, a, b, n, borrow);
+    }
+
+    // z += |x| * BASE^shift; z must already have room for the result.
+    static void addShiftedAbs(BigInt &z, const BigInt &x, std::size_t shift)
+    {
+        std::size_t i = x.mLimbs.size();
+        Limb carry = addLimbs(z.mLimbs.begin() + shift, z.mLimbs.begin() + shift, x.mLimbs.begin(), i, 0);
+
+        for (i += shift; carry != 0; i++)
+        {
+            Limb s = z.mLimbs[i] + carry;
+            carry = (s >= BASE) ? 1 : 0;
+            z.mLimbs[i] = s - carry * BASE;
+        }
+    }
+
+    // |a| += |b|, in place; a and b may be the same object.
+    static void addAbsInPlace(BigInt &a, const BigInt &b)
+    {
+        std::size_t n = b.mLimbs.size();
+
+        if (a.mLimbs.size() < n)
+        {
+            a.mLimbs.resize(n, 0);
+        }
+
+        Limb carry = addLimbs(a.mLimbs.begin(), a.mLimbs.begin(), b.mLimbs.begin(), n, 0);
+        std::size_t i = n;
+
+        for (; carry != 0 && i < a.mLimbs.size(); i++)
+        {
+            Limb s = a.mLimbs[i] + carry;
+            carry = (s >= BASE) ? 1 : 0;
+            a.mLimbs[i] = s - carry * BASE;
+        }
+
+        if (carry != 0)
+        {
+            a.mLimbs.push_back(carry);
+        }
+    }
+
+    // |a| -= |b|, in place; requires |a| >= |b|.
+    static void subAbsInPlace(BigInt &a, const BigInt &b)
+    {
+        std::size_t i = b.mLimbs.size();
+        Limb borrow = subLimbs(a.mLimbs.begin(), a.mLimbs.begin(), b.mLimbs.begin(), i, 0);
+
+        for (; borrow != 0; i++)
+        {
+            Limb s = a.mLimbs[i] + BASE - borrow;
+            borrow = (s < BASE) ? 1 : 0;
+            a.mLimbs[i] = s - (1 - borrow) * BASE;
+        }
+    }
+
+    // |a| = |b| - |a|, in place; requires |b| > |a|.
+    static void subAbsFromInPlace(BigInt &a, const BigInt &b)
+    {
+        a.mLimbs.resize(b.mLimbs.size(), 0);
+        subLimbs(a.mLimbs.begin(), b.mLimbs.begin(), a.mLimbs.begin(), b.mLimbs.size(), 0);
+    }
+
+    // a += b, or a -= b when negateB is set, reusing the limbs of a.
+    static void addInPlace(BigInt &a, const BigInt &b, bool negateB)
+    {
+        bool bNegative = (b.mIsNegative != negateB) && !b.mLimbs.empty();
+
+        if (a.mIsNegative == bNegative)
+        {
+            addAbsInPlace(a, b);
+        }
+        else if (compareAbs(a, b) >= 0)
+        {
+            subAbsInPlace(a, b);
+        }
+        else
+        {
+            subAbsFromInPlace(a, b);
+            a.mIsNegative = bNegative;
+        }
+
+        a.normalize();
+    }
+
+    static Limb modPowLimb(Limb base, DoubleLimb exp, Limb mod)
+    {
+        DoubleLimb result = 1, b = base % mod;
+
+        for (; exp > 0; exp >>= 1)
+        {
+            if (exp & 1)
+                result = result * b % mod;
+            b = b * b % mod;
+        }
+
+        return Limb(result);
+    }
+
+    // Fewest butterflies per thread when an NTT stage is split.
+    static const std::size_t NTT_GRAIN = std::size_t(1) << 14;
+
+    // Butterflies [from, to) of the NTT stage on blocks of 2 * half
+    // elements; butterfly k works on block k / half, offset k % half.
+    static void nttButterflies(Limb *v, const Limb *roots, std::size_t half, Limb mod,
+                               std::size_t from, std::size_t to)
+    {
+        for (std::size_t k = from; k < to;)
+        {
+            Limb *block = v + k / half * 2 * half;
+            std::size_t j = k % half;
+            std::size_t stop = std::min(half, j + (to - k));
+
+            for (; j < stop; j++, k++)
+            {
+                Limb u = block[j];
+                Limb t = Limb(DoubleLimb(block[j + half]) * roots[j] % mod);
+                block[j] = (u + t >= mod) ? u + t - mod : u + t;
+                block[j + half] = (u >= t) ? u - t : u + mod - t;
+            }
+        }
+    }
+
+    // In-place iterative NTT modulo a prime with primitive root 3.
+    static void nttTransform(std::vector<Limb> &v, bool invert, Limb mod)
+    {
+        std::size_t size = v.size();
+
+        for (std::size_t i = 1, j = 0; i < size; i++)
+        {
+            std::size_t bit = size >> 1;
+            for (; j & bit; bit >>= 1)
+            {
+                j ^= bit;
+            }
+            j ^= bit;
+
+            if (i < j)
+            {
+                std::swap(v[i], v[j]);
+            }
+        }
+
+        for (std::size_t len = 2; len <= size; len <<= 1)
+        {
+            DoubleLimb w = modPowLimb(3, (mod - 1) / len, mod);
+            if (invert)
+            {
+                w = modPowLimb(Limb(w), mod - 2, mod);
+            }
+
+            std::vector<Limb> roots(len / 2);
+            roots[0] = 1;
+            for (std::size_t i = 1; i < len / 2; i++)
+            {
+                roots[i] = Limb(roots[i - 1] * w % mod);
+            }
+
+            Limb *data = v.data();
+            const Limb *stageRoots = roots.data();
+            const std::size_t half = len / 2;
+            auto butterflies = [data, stageRoots, half, mod](std::size_t from, std::size_t to)
+            {
+                nttButterflies(data, stageRoots, half, mod, from, to);
+            };
+
+            if (runsParallel(size))
+            {
+                parallelFor(size / 2, NTT_GRAIN, butterflies);
+            }
+            else
+            {
+                butterflies(0, size / 2);
+            }
+        }
+
+        if (invert)
+        {
+            DoubleLimb sizeInv = modPowLimb(Limb(size % mod), mod - 2, mod);
+            for (auto &x : v)
+            {
+                x = Limb(x * sizeInv % mod);
+            }
+        }
+    }
+
+    static std::vector<Limb> nttConvolution(const LimbBuffer &a, const LimbBuffer &b,
+                                            std::size_t size, Limb mod)
+    {
+        std::vector<Limb> fa(size, 0), fb(size, 0);
+
+        for (std::size_t i = 0; i < a.size(); i++)
+        {
+            fa[i] = a[i] % mod;
+        }
+        for (std::size_t i = 0; i < b.size(); i++)
+        {
+            fb[i] = b[i] % mod;
+        }
+
+        if (runsParallel(size))
+        {
+            parallelInvoke({[&fa, mod]
+                            { nttTransform(fa, false, mod); },
+                            [&fb, mod]
+                            { nttTransform(fb, false, mod); }});
+        }
+        else
+        {
+            nttTransform(fa, false, mod);
+            nttTransform(fb, false, mod);
+        }
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            fa[i] = Limb(DoubleLimb(fa[i]) * fb[i] % mod);
+        }
+
+        nttTransform(fa, true, mod);
+
+        return fa;
+    }
+
+    // Sets the magnitude from the decimal digits in [first, last).
+    void assignDigits(const char *first, const char *last)
+    {
+        while (first != last && *first == '0')
+        {
+            first++;
+        }
+
+        mLimbs.clear();
+        mLimbs.reserve(std::size_t(last - first + BASE_DIGITS - 1) / BASE_DIGITS);
+
+        while (last != first)
+        {
+            const char *from = (last - first > BASE_DIGITS) ? last - BASE_DIGITS : first;
+            Limb limb = 0;
+
+            for (const char *p = from; p != last; p++)
+            {
+                limb = limb * 10 + Limb(*p - '0');
+            }
+
+            mLimbs.push_back(limb);
+            last = from;
+        }
+
+        normalize();
+    }
+
+    // x = p * |a| + q * |b| for |p|, |q| < 2^31; the result must not be
+    // negative.
+    static void linearCombination(BigInt &x, const BigInt &a, std::int64_t p, const BigInt &b, std::int64_t q)
+    {
+        std::size_t n = std::max(a.mLimbs.size(), b.mLimbs.size());
+        BigInt z;
+        z.mLimbs.assign(n, 0);
+
+        std::int64_t carry = 0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            std::int64_t t = carry;
+            if (i < a.mLimbs.size())
+                t += p * std::int64_t(a.mLimbs[i]);
+            if (i < b.mLimbs.size())
+                t += q * std::int64_t(b.mLimbs[i]);
+
+            carry = t / std::int64_t(BASE);
+            t %= std::int64_t(BASE);
+            if (t < 0)
+            {
+                t += BASE;
+                carry--;
+            }
+
+            z.mLimbs[i] = Limb(t);
+        }
+
+        for (; carry > 0; carry /= BASE)
+        {
+            z.mLimbs.push_back(Limb(carry % BASE));
+        }
+
+        z.normalize();
+        x.mLimbs.swap(z.mLimbs);
+        x.mIsNegative = false;
+    }
+
+    // Euclid on a >= b >= 0, batching quotient steps with Lehmer's method
+    // (Knuth, TAOCP vol. 2, 4.5.2, Algorithm L) on the leading two limbs, so
+    // most rounds cost one linear pass instead of a long division. Leaves
+    // the gcd in a and zero in b. With cofactors, sa and sb follow a and b
+    // as multiples of the original a modulo the original b.
+    static void lehmerGcd(BigInt &a, BigInt &b, BigInt &sa, BigInt &sb, bool withCofactors)
+    {
+        const std::int64_t LIMIT = std::int64_t(1) << 31;
+        BigInt q, r;
+
+        while (!b.mLimbs.empty())
+        {
+            std::size_t n = a.mLimbs.size();
+            std::int64_t A = 1, B = 0, C = 0, D = 1;
+
+            if (n >= 2 && b.mLimbs.size() + 1 >= n)
+            {
+                std::int64_t x = std::int64_t(a.mLimbs[n - 1]) * BASE + a.mLimbs[n - 2];
+                std::int64_t y = b.mLimbs[n - 2];
+                if (b.mLimbs.size() == n)
+                {
+                    y += std::int64_t(b.mLimbs[n - 1]) * BASE;
+                }
+
+                while (y + C != 0 && y + D != 0)
+                {
+                    std::int64_t q1 = (x + A) / (y + C);
+                    if (q1 != (x + B) / (y + D) || q1 >= LIMIT)
+                        break;
+
+                    std::int64_t nextC = A - q1 * C, nextD = B - q1 * D;
+                    if (nextC >= LIMIT || nextC <= -LIMIT || nextD >= LIMIT || nextD <= -LIMIT)
+                        break;
+
+                    A = C;
+                    B = D;
+                    C = nextC;
+                    D = nextD;
+
+                    std::int64_t nextY = x - q1 * y;
+                    x = y;
+                    y = nextY;
+                }
+            }
+
+            if (B == 0)
+            {
+                // no usable approximation: one full division step
+                divmodAbsValues(a, b, q, r);
+                std::swap(a, b);
+                std::swap(b, r);
+
+                if (withCofactors)
+                {
+                    sa -= q * sb;
+                    std::swap(sa, sb);
+                }
+            }
+            else
+            {
+                linearCombination(q, a, A, b, B);
+                linearCombination(r, a, C, b, D);
+                std::swap(a, q);
+                std::swap(b, r);
+
+                if (withCofactors)
+                {
+                    BigInt nextSa = sa * (long long)A + sb * (long long)B;
+                    sb = sa * (long long)C + sb * (long long)D;
+                    sa = std::move(nextSa);
+                }
+            }
+        }
+    }
+
+    // lo * (lo + 1) * ... * hi, splitting the range in halves so that the
+    // large multiplications are balanced; 1 for an empty range.
+    static BigInt rangeProduct(DoubleLimb lo, DoubleLimb hi)
+    {
+        BigInt r(1);
+
+        if (hi < lo)
+        {
+            return r;
+        }
+
+        if (hi - lo < 16)
+        {
+            for (DoubleLimb i = lo; i <= hi; i++)
+            {
+                r *= (long long)i;
+            }
+            return r;
+        }
+
+        DoubleLimb mid = lo + (hi - lo) / 2;
+        return rangeProduct(lo, mid) * rangeProduct(mid + 1, hi);
+    }
+
+    // Product of v[lo, hi), split the same way.
+    static BigInt productTree(const std::vector<Limb> &v, std::size_t lo, std::size_t hi)
+    {
+        if (hi - lo <= 16)
+        {
+            BigInt r(1);
+            for (std::size_t i = lo; i < hi; i++)
+            {
+                multiplyAbsSmall(r, v[i]);
+            }
+            return r;
+        }
+
+        std::size_t mid = lo + (hi - lo) / 2;
+        return productTree(v, lo, mid) * productTree(v, mid, hi);
+    }
+
+    static std::vector<Limb> primesUpTo(Limb n)
+    {
+        std::vector<bool> composite(std::size_t(n) + 1, false);
+        std::vector<Limb> primes;
+
+        for (DoubleLimb i = 2; i <= n; i++)
+        {
+            if (composite[i])
+                continue;
+
+            primes.push_back(Limb(i));
+            for (DoubleLimb j = i * i; j <= n; j += i)
+            {
+                composite[j] = true;
+            }
+        }
+
+        return primes;
+    }
+
+    // Exponent of the prime p in n! (Legendre's formula).
+    static DoubleLimb legendre(DoubleLimb n, Limb p)
+    {
+        DoubleLimb e = 0;
+
+        while (n > 0)
+        {
+            n /= p;
+            e += n;
+        }
+
+        return e;
+    }
+
+    // prod primes[i]^exps[i], built from the top exponent bit down: square,
+    // then multiply in the product of the primes whose exponent has that
+    // bit set.
+    static BigInt primePowerProduct(const std::vector<Limb> &primes, const std::vector<DoubleLimb> &exps)
+    {
+        DoubleLimb maxExp = 0;
+        for (DoubleLimb e : exps)
+        {
+            maxExp = std::max(maxExp, e);
+        }
+
+        int top = 0;
+        while (top < 63 && (maxExp >> (top + 1)) != 0)
+        {
+            top++;
+        }
+
+        BigInt result(1);
+        std::vector<Limb> group;
+
+        for (int bit = top; bit >= 0; bit--)
+        {
+            group.clear();
+            for (std::size_t i = 0; i < primes.size(); i++)
+            {
+                if ((exps[i] >> bit) & 1)
+                {
+                    group.push_back(primes[i]);
+                }
+            }
+
+            if (result != 1)
+            {
+                result = result * result;
+            }
+            if (!group.empty())
+            {
+                result *= productTree(group, 0, group.size());
+            }
+        }
+
+        return result;
+    }
+
+    // p * q modulo x^k - c[0] x^(k-1) - ... - c[k-1], for p and q of
+    // degree below k (coefficients lowest first).
+    static std::vector<BigInt> polyMulMod(const std::vector<BigInt> &p, const std::vector<BigInt> &q,
+                                          const std::vector<BigInt> &c)
+    {
+        const std::size_t k = c.size();
+        std::vector<BigInt> z(2 * k - 1);
+
+        for (std::size_t i = 0; i < k; i++)
+        {
+            if (p[i].mLimbs.empty())
+                continue;
+
+            for (std::size_t j = 0; j < k; j++)
+            {
+                if (!q[j].mLimbs.empty())
+                {
+                    z[i + j] += p[i] * q[j];
+                }
+            }
+        }
+
+        for (std::size_t d = z.size(); d-- > k;)
+        {
+            if (z[d].mLimbs.empty())
+                continue;
+
+            for (std::size_t j = 0; j < k; j++)
+            {
+                z[d - 1 - j] += z[d] * c[j];
+            }
+        }
+
+        z.resize(k);
+        return z;
+    }
+
+    // x * p under the same modulus.
+    static void polyShiftMod(std::vector<BigInt> &p, const std::vector<BigInt> &c)
+    {
+        const std::size_t k = c.size();
+        BigInt top = std::move(p[k - 1]);
+
+        for (std::size_t i = k - 1; i > 0; i--)
+        {
+            p[i] = std::move(p[i - 1]);
+        }
+        p[0] = BigInt();
+
+        if (!top.mLimbs.empty())
+        {
+            for (std::size_t j = 0; j < k; j++)
+            {
+                p[k - 1 - j] += top * c[j];
+            }
+        }
+    }
+
+    // An integer no smaller than |x|^(1/k), from a floating-point estimate
+    // of the leading limbs; used when the root has at most two limbs.
+    static BigInt rootEstimate(const BigInt &x, unsigned k)
+    {
+        std::size_t n = x.mLimbs.size(), lead = std::min<std::size_t>(n, 3);
+
+        double top = 0;
+        for (std::size_t i = n; i-- > n - lead;)
+        {
+            top = top * BASE + x.mLimbs[i];
+        }
+
+        double digits = std::log10(top) + double(BASE_DIGITS) * double(n - lead);
+        return BigInt((long long)(std::pow(10.0, digits / k) * (1 + 1e-9)) + 1);
+    }
+
+    // floor(|x|^(1/k)) for k >= 2. The root of the leading half of x,
+    // rounded up and shifted back, gives a start with half the digits
+    // right; Newton's iteration from above then needs only a couple of
+    // steps. The quotient and power buffers are shared across steps.
+    static BigInt rootAbs(const BigInt &x, unsigned k)
+    {
+        const std::size_t n = x.mLimbs.size();
+        const std::size_t t = n / (2 * k);
+
+        if (n == 0)
+        {
+            return BigInt();
+        }
+
+        BigInt y;
+        if (t == 0)
+        {
+            y = rootEstimate(x, k);
+        }
+        else
+        {
+            BigInt head = rootAbs(slice(x, t * k, n), k);
+            addAbsSmall(head, 1);
+            y.mLimbs.assign(t + head.mLimbs.size() + 1, 0);
+            addShiftedAbs(y, head, t);
+            y.normalize();
+        }
+
+        // y' = ((k - 1) y + x / y^(k-1)) / k decreases until it reaches the root
+        BigInt power, q, r, next;
+        for (;;)
+        {
+            if (k == 2)
+            {
+                divmodAbsValues(x, y, q, r);
+            }
+            else
+            {
+                power = pow(y, k - 1);
+                divmodAbsValues(x, power, q, r);
+            }
+
+            next = y;
+            multiplyAbsSmall(next, k - 1);
+            addAbsInPlace(next, q);
+            divideAbsSmall(next, k);
+
+            if (compareAbs(next, y) >= 0)
+            {
+                return y;
+            }
+
+            std::swap(y, next);
+        }
+    }
+
+    // False when |x| is provably not a p-th power: for a prime q = 1 (mod p)
+    // not dividing x, a p-th power satisfies x^((q-1)/p) = 1 (mod q). A
+    // few such q reject almost every non-power at O(n) each.
+    static bool mayBePower(const BigInt &x, Limb p)
+    {
+        const DoubleLimb LIMIT = DoubleLimb(1) << 31;
+        int tests = 0;
+
+        for (DoubleLimb q = 2 * DoubleLimb(p) + 1; tests < 4 && q < LIMIT; q += 2 * DoubleLimb(p))
+        {
+            bool prime = true;
+            for (DoubleLimb d = 3; d * d <= q; d += 2)
+            {
+                if (q % d == 0)
+                {
+                    prime = false;
+                    break;
+                }
+            }
+
+            if (!prime)
+                continue;
+
+            tests++;
+            Limb rem = modAbsSmall(x, Limb(q));
+            if (rem != 0 && modPowLimb(rem, (q - 1) / p, Limb(q)) != 1)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static const long long MAX_SIEVE_ARGUMENT = 0xffffffffLL;
+
+    static const std::size_t SERIAL_HEADER_BYTES = 8;
+
+    // Limbs to and from little-endian 32-bit words; a plain copy on
+    // little-endian hosts.
+    static void storeLimbs(unsigned char *out, const Limb *limbs, std::size_t n)
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        if (n != 0)
+        {
+            std::memcpy(out, limbs, n * sizeof(Limb));
+        }
+#else
+        for (std::size_t i = 0; i < n; i++)
+        {
+            for (int b = 0; b < 4; b++)
+            {
+                out[4 * i + b] = static_cast<unsigned char>(limbs[i] >> (8 * b));
+            }
+        }
+#endif
+    }
+
+    static void loadLimbs(Limb *limbs, const unsigned char *in, std::size_t n)
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        if (n != 0)
+        {
+            std::memcpy(limbs, in, n * sizeof(Limb));
+        }
+#else
+        for (std::size_t i = 0; i < n; i++)
+        {
+            limbs[i] = Limb(in[4 * i]) | Limb(in[4 * i + 1]) << 8 | Limb(in[4 * i + 2]) << 16 | Limb(in[4 * i + 3]) << 24;
+        }
+#endif
+    }
+
+public:
+    class Modulus;
+    class FactorialTable;
+    class View;
+
+    static BigInt abs(const BigInt &);
+
+    // Lets products of operands with at least minLimbs limbs split their
+    // subproducts and NTT passes over up to threads threads (0 picks the
+    // hardware concurrency; 1, the default, keeps everything on the
+    // calling thread). Not to be called while a multiplication runs.
+    static void setParallelism(unsigned threads, std::size_t minLimbs = PARALLEL_THRESHOLD)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        ParallelState &state = parallelState();
+        state.pool.reset();
+        state.threads = threads;
+        state.minLimbs = std::max(minLimbs, std::size_t(KARATSUBA_THRESHOLD));
+
+        if (threads > 1)
+        {
+            state.pool.reset(new au_detail::ThreadPool(threads - 1));
+        }
+    }
+
+    static unsigned parallelism()
+    {
+        return parallelState().threads;
+    }
+
+    // Counters of the limb blocks the calling thread has taken and freed
+    // since it started or last called resetAllocationStats.
+    static AllocationStats allocationStats()
+    {
+        return LimbPool::stats();
+    }
+
+    static void resetAllocationStats()
+    {
+        LimbPool::resetStats();
+    }
+
+    // Hands the blocks the calling thread keeps for reuse back to the
+    // heap, e.g. after a job that built many large temporaries.
+    static void releaseCachedLimbs()
+    {
+        LimbPool::trim();
+    }
+
+    // base^exp mod mod, in [0, mod); exp must be non-negative.
+    static BigInt powMod(const BigInt &base, const BigInt &exp, const BigInt &mod);
+
+    // -1, 0 or 1 as |a| is less than, equal to or greater than |b|.
+    static int compareAbs(const BigInt &a, const BigInt &b)
+    {
+        if (a.mLimbs.size() != b.mLimbs.size())
+        {
+            return (a.mLimbs.size() < b.mLimbs.size()) ? -1 : 1;
+        }
+
+        for (std::size_t i = a.mLimbs.size(); i-- > 0;)
+        {
+            if (a.mLimbs[i] != b.mLimbs[i])
+            {
+                return (a.mLimbs[i] < b.mLimbs[i]) ? -1 : 1;
+            }
+        }
+
+        return 0;
+    }
+
+    // -1, 0 or 1 as a is less than, equal to or greater than b.
+    static int compare(const BigInt &a, const BigInt &b)
+    {
+        if (a.mIsNegative != b.mIsNegative)
+        {
+            return a.mIsNegative ? -1 : 1;
+        }
+
+        int c = compareAbs(a, b);
+        return a.mIsNegative ? -c : c;
+    }
+
+    // -1, 0 or 1 as |x| is less than, equal to or greater than v.
+    static int compareAbs(const BigInt &x, DoubleLimb v)
+    {
+        // 2^64 < BASE^3, so anything longer is larger
+        if (x.mLimbs.size() > 3)
+        {
+            return 1;
+        }
+
+        // compare as (high, low) pairs to avoid overflowing 64 bits
+        DoubleLimb low = 0, high = 0;
+        for (std::size_t i = x.mLimbs.size(); i-- > 1;)
+        {
+            high = high * BASE + x.mLimbs[i];
+        }
+        if (!x.mLimbs.empty())
+        {
+            low = x.mLimbs[0];
+        }
+
+        DoubleLimb vHigh = v / BASE, vLow = v % BASE;
+
+        if (high != vHigh)
+        {
+            return (high < vHigh) ? -1 : 1;
+        }
+
+        return (low < vLow) ? -1 : (low > vLow) ? 1 : 0;
+    }
+
+    // -1, 0 or 1 as x is less than, equal to or greater than v.
+    static int compare(const BigInt &x, long long v)
+    {
+        bool negative = v < 0;
+
+        if (x.mIsNegative != negative)
+        {
+            return x.mIsNegative ? -1 : 1;
+        }
+
+        int c = compareAbs(x, magnitude(v));
+        return negative ? -c : c;
+    }
+
+    BigInt() : mIsNegative(false)
+    {
+    }
+
+    BigInt(const BigInt &) = default;
+    BigInt &operator=(const BigInt &) = default;
+
+    // A moved-from BigInt is left equal to zero.
+    BigInt(BigInt &&other) noexcept : mLimbs(std::move(other.mLimbs)), mIsNegative(other.mIsNegative)
+    {
+        other.mLimbs.clear();
+        other.mIsNegative = false;
+    }
+
+    BigInt &operator=(BigInt &&other) noexcept
+    {
+        if (this != &other)
+        {
+            mLimbs = std::move(other.mLimbs);
+            mIsNegative = other.mIsNegative;
+            other.mLimbs.clear();
+            other.mIsNegative = false;
+        }
+
+        return *this;
+    }
+
+    // Reads an optionally signed run of decimal digits after leading
+    // whitespace and ignores whatever follows it, in linear time.
+    BigInt(const std::string &s) : mIsNegative(false)
+    {
+        std::size_t i = 0, n = s.size();
+
+        while (i < n && std::isspace(static_cast<unsigned char>(s[i])))
+        {
+            i++;
+        }
+
+        if (i < n && (s[i] == '+' || s[i] == '-'))
+        {
+            mIsNegative = (s[i] == '-');
+            i++;
+        }
+
+        std::size_t first = i;
+
+        while (i < n && std::isdigit(static_cast<unsigned char>(s[i])))
+        {
+            i++;
+        }
+
+        if (first == i)
+        {
+            mIsNegative = false;
+            throw std::runtime_error("invalid representation of BigInt value");
+        }
+
+        assignDigits(s.data() + first, s.data() + i);
+    }
+
+    BigInt(const long long val) : mIsNegative(val < 0)
+    {
+        for (DoubleLimb m = magnitude(val); m != 0; m /= BASE)
+        {
+            mLimbs.push_back(Limb(m % BASE));
+        }
+    }
+
+    static BigInt addAbsValues(const BigInt &a, const BigInt &b)
+    {
+        const BigInt &longer = a.mLimbs.size() >= b.mLimbs.size() ? a : b;
+        const BigInt &shorter = a.mLimbs.size() >= b.mLimbs.size() ? b : a;
+
+        BigInt z;
+        z.mLimbs.resize(longer.mLimbs.size() + 1);
+
+        std::size_t i = shorter.mLimbs.size();
+        Limb carry = addLimbs(z.mLimbs.begin(), longer.mLimbs.begin(), shorter.mLimbs.begin(), i, 0);
+
+        for (; i < longer.mLimbs.size(); i++)
+        {
+            Limb s = longer.mLimbs[i] + carry;
+            carry = (s >= BASE) ? 1 : 0;
+            z.mLimbs[i] = s - carry * BASE;
+        }
+
+        z.mLimbs[i] = carry;
+        z.normalize();
+
+        return z;
+    }
+
+    // Requires |a| >= |b|.
+    static BigInt subAbsValues(const BigInt &a, const BigInt &b)
+    {
+        BigInt z;
+        z.mLimbs.resize(a.mLimbs.size());
+
+        std::size_t i = b.mLimbs.size();
+        Limb borrow = subLimbs(z.mLimbs.begin(), a.mLimbs.begin(), b.mLimbs.begin(), i, 0);
+
+        for (; i < a.mLimbs.size(); i++)
+        {
+            Limb s = a.mLimbs[i] + BASE - borrow;
+            borrow = (s < BASE) ? 1 : 0;
+            z.mLimbs[i] = s - (1 - borrow) * BASE;
+        }
+
+        z.normalize();
+
+        return z;
+    }
+
+    static BigInt multiplyAbsValues(const BigInt &a, const BigInt &b)
+    {
+        std::size_t n = a.mLimbs.size(), m = b.mLimbs.size();
+
+        if (n < m)
+        {
+            return multiplyAbsValues(b, a);
+        }
+
+        if (m < KARATSUBA_THRESHOLD)
+        {
+            return schoolbookMultiply(a, b);
+        }
+
+        if (m >= NTT_THRESHOLD && n + m <= NTT_MAX_LIMBS)
+        {
+            return nttMultiply(a, b);
+        }
+
+        // unbalanced operands: multiply m-limb slices of a by b
+        if (n >= 2 * m)
+        {
+            BigInt z;
+            z.mLimbs.assign(n + m, 0);
+
+            std::vector<BigInt> parts((n + m - 1) / m);
+            auto multiplyParts = [&parts, &a, &b, m](std::size_t lo, std::size_t hi)
+            {
+                for (std::size_t i = lo; i < hi; i++)
+                {
+                    parts[i] = multiplyAbsValues(slice(a, i * m, m), b);
+                }
+            };
+
+            if (runsParallel(m))
+            {
+                parallelFor(parts.size(), 1, multiplyParts);
+            }
+            else
+            {
+                multiplyParts(0, parts.size());
+            }
+
+            for (std::size_t i = 0; i < parts.size(); i++)
+            {
+                addShiftedAbs(z, parts[i], i * m);
+            }
+
+            z.normalize();
+            return z;
+        }
+
+        if (m < TOOM3_THRESHOLD)
+        {
+            return karatsubaMultiply(a, b);
+        }
+
+        return toom3Multiply(a, b);
+    }
+
+    static BigInt schoolbookMultiply(const BigInt &a, const BigInt &b)
+    {
+        BigInt z;
+        std::size_t n = a.mLimbs.size(), m = b.mLimbs.size();
+
+        if (n == 0 || m == 0)
+        {
+            return z;
+        }
+
+        z.mLimbs.assign(n + m, 0);
+
+        for (std::size_t i = 0; i < n; i++)
+        {
+            DoubleLimb carry = 0;
+
+            for (std::size_t j = 0; j < m; j++)
+            {
+                DoubleLimb cur = z.mLimbs[i + j] + DoubleLimb(a.mLimbs[i]) * b.mLimbs[j] + carry;
+                z.mLimbs[i + j] = Limb(cur % BASE);
+                carry = cur / BASE;
+            }
+
+            for (std::size_t k = i + m; carry != 0; k++)
+            {
+                DoubleLimb cur = z.mLimbs[k] + carry;
+                z.mLimbs[k] = Limb(cur % BASE);
+                carry = cur / BASE;
+            }
+        }
+
+        z.normalize();
+
+        return z;
+    }
+
+    // a * b = z2 * B^2k + ((a0 + a1)(b0 + b1) - z2 - z0) * B^k + z0
+    static BigInt karatsubaMultiply(const BigInt &a, const BigInt &b)
+    {
+        std::size_t n = std::max(a.mLimbs.size(), b.mLimbs.size());
+
+        if (std::min(a.mLimbs.size(), b.mLimbs.size()) < KARATSUBA_THRESHOLD)
+        {
+            return schoolbookMultiply(a, b);
+        }
+
+        std::size_t k = n / 2;
+
+        BigInt a0 = slice(a, 0, k), a1 = slice(a, k, n);
+        BigInt b0 = slice(b, 0, k), b1 = slice(b, k, n);
+
+        BigInt z0, z1, z2, sa = addAbsValues(a0, a1), sb = addAbsValues(b0, b1);
+        std::vector<std::function<void()>> products{
+            [&]
+            { z0 = multiplyAbsValues(a0, b0); },
+            [&]
+            { z2 = multiplyAbsValues(a1, b1); },
+            [&]
+            { z1 = multiplyAbsValues(sa, sb); }};
+
+        if (runsParallel(n))
+        {
+            parallelInvoke(products);
+        }
+        else
+        {
+            for (auto &task : products)
+            {
+                task();
+            }
+        }
+
+        z1 = subAbsValues(subAbsValues(z1, z0), z2);
+
+        BigInt z;
+        z.mLimbs.assign(a.mLimbs.size() + b.mLimbs.size(), 0);
+        addShiftedAbs(z, z0, 0);
+        addShiftedAbs(z, z1, k);
+        addShiftedAbs(z, z2, 2 * k);
+        z.normalize();
+
+        return z;
+    }
+
+    // Toom-3 evaluated at 0, 1, -1, -2 and infinity, interpolated with
+    // Bodrato's sequence
+    static BigInt toom3Multiply(const BigInt &a, const BigInt &b)
+    {
+        std::size_t n = std::max(a.mLimbs.size(), b.mLimbs.size());
+
+        if (std::min(a.mLimbs.size(), b.mLimbs.size()) < KARATSUBA_THRESHOLD)
+        {
+            return schoolbookMultiply(a, b);
+        }
+
+        std::size_t k = (n + 2) / 3;
+
+        BigInt a0 = slice(a, 0, k), a1 = slice(a, k, k), a2 = slice(a, 2 * k, n);
+        BigInt b0 = slice(b, 0, k), b1 = slice(b, k, k), b2 = slice(b, 2 * k, n);
+
+        BigInt t = a0 + a2;
+        BigInt pa1 = t + a1, paM1 = t - a1;
+        BigInt paM2 = multiplyBySmall(paM1 + a2, 2) - a0;
+
+        t = b0 + b2;
+        BigInt pb1 = t + b1, pbM1 = t - b1;
+        BigInt pbM2 = multiplyBySmall(pbM1 + b2, 2) - b0;
+
+        BigInt r0, r1, rM1, rM2, rInf;
+        std::vector<std::function<void()>> products{
+            [&]
+            { r0 = multiplyAbsValues(a0, b0); },
+            [&]
+            { r1 = pa1 * pb1; },
+            [&]
+            { rM1 = paM1 * pbM1; },
+            [&]
+            { rM2 = paM2 * pbM2; },
+            [&]
+            { rInf = multiplyAbsValues(a2, b2); }};
+
+        if (runsParallel(n))
+        {
+            parallelInvoke(products);
+        }
+        else
+        {
+            for (auto &task : products)
+            {
+                task();
+            }
+        }
+
+        BigInt c3 = divideBySmall(rM2 - r1, 3);
+        BigInt c1 = divideBySmall(r1 - rM1, 2);
+        BigInt c2 = rM1 - r0;
+        c3 = divideBySmall(c2 - c3, 2) + multiplyBySmall(rInf, 2);
+        c2 = c2 + c1 - rInf;
+        c1 = c1 - c3;
+
+        BigInt z;
+        z.mLimbs.assign(a.mLimbs.size() + b.mLimbs.size() + 1, 0);
+        addShiftedAbs(z, r0, 0);
+        addShiftedAbs(z, c1, k);
+        addShiftedAbs(z, c2, 2 * k);
+        addShiftedAbs(z, c3, 3 * k);
+        addShiftedAbs(z, rInf, 4 * k);
+        z.normalize();
+
+        return z;
+    }
+
+    // Product via number-theoretic transforms modulo three NTT primes,
+    // combined with Garner's CRT. Exact while min(n, m) * BASE^2 stays
+    // below the product of the primes and n + m <= NTT_MAX_LIMBS.
+    static BigInt nttMultiply(const BigInt &a, const BigInt &b)
+    {
+        BigInt z;
+        std::size_t n = a.mLimbs.size(), m = b.mLimbs.size();
+
+        if (n == 0 || m == 0)
+        {
+            return z;
+        }
+
+        std::size_t size = 1;
+        while (size < n + m)
+        {
+            size <<= 1;
+        }
+
+        const Limb primes[3] = {167772161, 469762049, 998244353};
+        std::vector<Limb> residues[3];
+
+        std::vector<std::function<void()>> convolutions;
+        for (int k = 0; k < 3; k++)
+        {
+            convolutions.push_back([&residues, &primes, &a, &b, size, k]
+                                   { residues[k] = nttConvolution(a.mLimbs, b.mLimbs, size, primes[k]); });
+        }
+
+        if (runsParallel(size))
+        {
+            parallelInvoke(convolutions);
+        }
+        else
+        {
+            for (auto &task : convolutions)
+            {
+                task();
+            }
+        }
+
+        const DoubleLimb p0 = primes[0], p1 = primes[1], p2 = primes[2];
+        const DoubleLimb p01 = p0 * p1;
+        const DoubleLimb inv0 = modPowLimb(Limb(p0 % p1), p1 - 2, primes[1]);
+        const DoubleLimb inv01 = modPowLimb(Limb(p01 % p2), p2 - 2, primes[2]);
+        const DoubleLimb p01High = p01 / BASE, p01Low = p01 % BASE;
+
+        z.mLimbs.assign(n + m, 0);
+
+        // carry = carryLow + carryHigh * BASE
+        DoubleLimb carryLow = 0, carryHigh = 0;
+
+        for (std::size_t i = 0; i < n + m; i++)
+        {
+            DoubleLimb r0 = residues[0][i], r1 = residues[1][i], r2 = residues[2][i];
+
+            // x = r0 + p0 * k1 + p0 * p1 * k2
+            DoubleLimb k1 = (r1 + p1 - r0 % p1) % p1 * inv0 % p1;
+            DoubleLimb x01 = r0 + p0 * k1;
+            DoubleLimb k2 = (r2 + p2 - x01 % p2) % p2 * inv01 % p2;
+
+            // split x into base-BASE digits d0 + d1 * BASE + d2 * BASE^2
+            DoubleLimb t0 = x01 % BASE + k2 * p01Low + carryLow;
+            DoubleLimb t1 = x01 / BASE + k2 * p01High + carryHigh + t0 / BASE;
+
+            z.mLimbs[i] = Limb(t0 % BASE);
+            carryLow = t1 % BASE;
+            carryHigh = t1 / BASE;
+        }
+
+        z.normalize();
+
+        return z;
+    }
+
+    // Quotient and remainder of |a| / |b| in one pass (Knuth, TAOCP vol. 2,
+    // 4.3.1, Algorithm D).
+    static void divmodAbsValues(const BigInt &a, const BigInt &b, BigInt &quotient, BigInt &remainder)
+    {
+        BigInt q, r;
+
+        if (compareAbs(a, b) < 0)
+        {
+            r = a;
+            r.mIsNegative = false;
+        }
+        else if (b.mLimbs.size() == 1)
+        {
+            Limb rem;
+            q = divideBySmall(a, b.mLimbs[0], rem);
+            q.mIsNegative = false;
+            r = BigInt(rem);
+        }
+        else
+        {
+            std::size_t n = a.mLimbs.size(), m = b.mLimbs.size();
+
+            // scale so that the top limb of the divisor is at least BASE / 2
+            Limb d = Limb(BASE / (DoubleLimb(b.mLimbs.back()) + 1));
+            LimbBuffer u = multiplyBySmall(a, d).mLimbs;
+            LimbBuffer v = multiplyBySmall(b, d).mLimbs;
+            u.resize(n + 1, 0);
+
+            const DoubleLimb vTop = v[m - 1], vNext = v[m - 2];
+            q.mLimbs.assign(n - m + 1, 0);
+
+            for (std::size_t j = n - m + 1; j-- > 0;)
+            {
+                DoubleLimb num = u[j + m] * DoubleLimb(BASE) + u[j + m - 1];
+                DoubleLimb qhat = num / vTop, rhat = num % vTop;
+
+                while (qhat >= BASE || qhat * vNext > rhat * BASE + u[j + m - 2])
+                {
+                    qhat--;
+                    rhat += vTop;
+
+                    if (rhat >= BASE)
+                        break;
+                }
+
+                // u[j .. j + m] -= qhat * v
+                std::int64_t borrow = 0;
+                DoubleLimb carry = 0;
+
+                for (std::size_t i = 0; i < m; i++)
+                {
+                    DoubleLimb p = qhat * v[i] + carry;
+                    carry = p / BASE;
+
+                    std::int64_t t = std::int64_t(u[i + j]) - std::int64_t(p % BASE) - borrow;
+                    borrow = (t < 0) ? 1 : 0;
+                    u[i + j] = Limb(t + borrow * BASE);
+                }
+
+                std::int64_t top = std::int64_t(u[j + m]) - std::int64_t(carry) - borrow;
+
+                if (top < 0)
+                {
+                    // qhat was one too large: add the divisor back
+                    qhat--;
+                    Limb c = 0;
+
+                    for (std::size_t i = 0; i < m; i++)
+                    {
+                        Limb s = u[i + j] + v[i] + c;
+                        c = (s >= BASE) ? 1 : 0;
+                        u[i + j] = s - c * BASE;
+                    }
+
+                    top += c;
+                }
+
+                u[j + m] = Limb(top);
+                q.mLimbs[j] = Limb(qhat);
+            }
+
+            q.normalize();
+
+            u.resize(m);
+            r.mLimbs.swap(u);
+            r.normalize();
+            r = divideBySmall(r, d);
+        }
+
+        quotient.mLimbs.swap(q.mLimbs);
+        quotient.mIsNegative = false;
+        remainder.mLimbs.swap(r.mLimbs);
+        remainder.mIsNegative = false;
+    }
+
+    // Truncating division: quotient rounds toward zero and the remainder
+    // takes the sign of a, so a == quotient * b + remainder.
+    static void divmod(const BigInt &a, const BigInt &b, BigInt &quotient, BigInt &remainder)
+    {
+        if (b.mLimbs.empty())
+        {
+            throw std::runtime_error("division by zero occurred!");
+        }
+
+        bool quotientNegative = (a.mIsNegative != b.mIsNegative);
+        bool remainderNegative = a.mIsNegative;
+
+        divmodAbsValues(a, b, quotient, remainder);
+
+        quotient.mIsNegative = quotientNegative;
+        quotient.normalize();
+        remainder.mIsNegative = remainderNegative;
+        remainder.normalize();
+    }
+
+    static BigInt divideAbsValues(const BigInt &a, const BigInt &b)
+    {
+        BigInt q, r;
+        divmodAbsValues(a, b, q, r);
+        return q;
+    }
+
+    static BigInt modDivideAbsValues(const BigInt &a, const BigInt &b)
+    {
+        BigInt q, r;
+        divmodAbsValues(a, b, q, r);
+        return r;
+    }
+
+    // Greatest common divisor of |a| and |b|; gcd(0, 0) is 0.
+    static BigInt gcd(const BigInt &a, const BigInt &b)
+    {
+        BigInt x = abs(a), y = abs(b), sx, sy;
+
+        if (compareAbs(x, y) < 0)
+        {
+            std::swap(x, y);
+        }
+
+        lehmerGcd(x, y, sx, sy, false);
+        return x;
+    }
+
+    // Returns g = gcd(a, b) and sets x and y so that a * x + b * y == g.
+    static BigInt extendedGcd(const BigInt &a, const BigInt &b, BigInt &x, BigInt &y)
+    {
+        BigInt u = abs(a), v = abs(b);
+        bool swapped = compareAbs(u, v) < 0;
+
+        if (swapped)
+        {
+            std::swap(u, v);
+        }
+
+        const BigInt u0 = u, v0 = v;
+        BigInt su(1), sv;
+        lehmerGcd(u, v, su, sv, true);
+
+        // u == su * u0 + k * v0 exactly
+        BigInt k;
+        if (!v0.mLimbs.empty())
+        {
+            k = (u - su * u0) / v0;
+        }
+
+        BigInt ca = swapped ? k : su, cb = swapped ? su : k;
+        if (a.mIsNegative)
+            ca = -ca;
+        if (b.mIsNegative)
+            cb = -cb;
+
+        x = std::move(ca);
+        y = std::move(cb);
+        return u;
+    }
+
+    // n! as the product of its prime powers.
+    static BigInt factorial(long long n)
+    {
+        if (n < 0)
+        {
+            throw std::runtime_error("BigInt: factorial of a negative number");
+        }
+        if (n > MAX_SIEVE_ARGUMENT)
+        {
+            throw std::runtime_error("BigInt: factorial argument too large");
+        }
+
+        if (n < 64)
+        {
+            return rangeProduct(2, DoubleLimb(n));
+        }
+
+        std::vector<Limb> primes = primesUpTo(Limb(n));
+        std::vector<DoubleLimb> exps(primes.size());
+        for (std::size_t i = 0; i < primes.size(); i++)
+        {
+            exps[i] = legendre(DoubleLimb(n), primes[i]);
+        }
+
+        return primePowerProduct(primes, exps);
+    }
+
+    // n choose k for n >= 0; zero when k is outside [0, n].
+    static BigInt binomial(long long n, long long k)
+    {
+        if (n < 0)
+        {
+            throw std::runtime_error("BigInt: binomial of a negative number");
+        }
+        if (k < 0 || k > n)
+        {
+            return BigInt();
+        }
+
+        k = std::min(k, n - k);
+
+        // few factors: n (n-1) ... (n-k+1) / k!, exact at every step
+        if (k <= 64)
+        {
+            BigInt r(1);
+            for (long long i = 1; i <= k; i++)
+            {
+                r *= n - k + i;
+                divideAbsSmall(r, Limb(i));
+            }
+            return r;
+        }
+
+        if (n > MAX_SIEVE_ARGUMENT)
+        {
+            throw std::runtime_error("BigInt: binomial argument too large");
+        }
+
+        // Kummer: the exponent of p is e(n!) - e(k!) - e((n-k)!)
+        std::vector<Limb> primes = primesUpTo(Limb(n)), used;
+        std::vector<DoubleLimb> exps;
+        for (Limb p : primes)
+        {
+            DoubleLimb e = legendre(DoubleLimb(n), p) - legendre(DoubleLimb(k), p) - legendre(DoubleLimb(n - k), p);
+            if (e != 0)
+            {
+                used.push_back(p);
+                exps.push_back(e);
+            }
+        }
+
+        return primePowerProduct(used, exps);
+    }
+
+    // F(n) by fast doubling, one bit of n at a time from the top:
+    // F(2k) = F(k) (2 F(k+1) - F(k)) and F(2k+1) = F(k)^2 + F(k+1)^2.
+    // Negative n follows F(-n) = (-1)^(n+1) F(n).
+    static BigInt fibonacci(long long n)
+    {
+        DoubleLimb m = magnitude(n);
+        BigInt a, b(1);
+
+        int top = 63;
+        while (top >= 0 && ((m >> top) & 1) == 0)
+        {
+            top--;
+        }
+
+        for (int bit = top; bit >= 0; bit--)
+        {
+            BigInt c = a * (b + b - a);
+            BigInt d = a * a + b * b;
+
+            if ((m >> bit) & 1)
+            {
+                a = std::move(d);
+                b = std::move(c);
+                b += a;
+            }
+            else
+            {
+                a = std::move(c);
+                b = std::move(d);
+            }
+        }
+
+        if (n < 0 && m % 2 == 0)
+        {
+            a = -std::move(a);
+        }
+
+        return a;
+    }
+
+    // Term n of a(i) = c[0] a(i-1) + c[1] a(i-2) + ... + c[k-1] a(i-k),
+    // given a(0) .. a(k-1) in initial. Computes x^n modulo the
+    // characteristic polynomial by binary powering (Kitamasa), so the
+    // cost is O(k^2 log n) big multiplications.
+    static BigInt linearRecurrence(const std::vector<BigInt> &c, const std::vector<BigInt> &initial, long long n)
+    {
+        const std::size_t k = c.size();
+
+        if (k == 0 || initial.size() != k)
+        {
+            throw std::runtime_error("BigInt: recurrence needs as many initial terms as coefficients");
+        }
+        if (n < 0)
+        {
+            throw std::runtime_error("BigInt: negative recurrence index");
+        }
+        if (DoubleLimb(n) < k)
+        {
+            return initial[std::size_t(n)];
+        }
+
+        std::vector<BigInt> r(k);
+        r[0] = 1;
+
+        int top = 62;
+        while ((n >> top) == 0)
+        {
+            top--;
+        }
+
+        for (int bit = top; bit >= 0; bit--)
+        {
+            r = polyMulMod(r, r, c);
+            if ((n >> bit) & 1)
+            {
+                polyShiftMod(r, c);
+            }
+        }
+
+        BigInt result;
+        for (std::size_t i = 0; i < k; i++)
+        {
+            if (!r[i].mLimbs.empty())
+            {
+                result += r[i] * initial[i];
+            }
+        }
+
+        return result;
+    }
+
+    // base^exp by binary powering; exp must be non-negative.
+    static BigInt pow(const BigInt &base, long long exp)
+    {
+        if (exp < 0)
+        {
+            throw std::runtime_error("BigInt: negative exponent");
+        }
+
+        BigInt result(1), b = base;
+
+        for (; exp > 0; exp >>= 1)
+        {
+            if (exp & 1)
+            {
+                result *= b;
+            }
+            if (exp > 1)
+            {
+                b = b * b;
+            }
+        }
+
+        return result;
+    }
+
+    // floor(sqrt(x)) for x >= 0.
+    static BigInt isqrt(const BigInt &x)
+    {
+        if (x.mIsNegative)
+        {
+            throw std::runtime_error("BigInt: square root of a negative number");
+        }
+
+        return rootAbs(x, 2);
+    }
+
+    // The k-th root of x rounded toward zero; x may be negative only for
+    // odd k.
+    static BigInt iroot(const BigInt &x, long long k)
+    {
+        if (k < 1)
+        {
+            throw std::runtime_error("BigInt: root degree must be positive");
+        }
+        if (x.mIsNegative && k % 2 == 0)
+        {
+            throw std::runtime_error("BigInt: even root of a negative number");
+        }
+
+        if (k == 1)
+        {
+            return x;
+        }
+
+        // |x| < 2^k for k above the bit length, so the root is 0 or 1
+        DoubleLimb bits = DoubleLimb(x.mLimbs.size()) * 30;
+        BigInt r = (DoubleLimb(k) > bits) ? BigInt(x.mLimbs.empty() ? 0 : 1) : rootAbs(x, unsigned(k));
+        r.mIsNegative = x.mIsNegative;
+        r.normalize();
         return r;
     }
 
-    if (!a.mIsNegative && b.mIsNegative)
+    static bool isPerfectPower(const BigInt &x)
+    {
+        BigInt base;
+        long long exponent;
+        return isPerfectPower(x, base, exponent);
+    }
+
+    // Whether x == base^exponent for some exponent >= 2; on success sets
+    // the largest such exponent. 0, 1 and -1 count as squares or cubes.
+    static bool isPerfectPower(const BigInt &x, BigInt &base, long long &exponent)
+    {
+        if (compareAbs(x, 1) <= 0)
+        {
+            base = x;
+            exponent = x.mIsNegative ? 3 : 2;
+            return true;
+        }
+
+        BigInt b = abs(x);
+        long long e = 1;
+
+        for (bool found = true; found;)
+        {
+            found = false;
+
+            // BASE < 2^30, so b has fewer than 30 bits per limb
+            for (Limb p : primesUpTo(Limb(b.mLimbs.size() * 30)))
+            {
+                if ((x.mIsNegative && p == 2) || !mayBePower(b, p))
+                    continue;
+
+                BigInt r = rootAbs(b, p);
+                if (compareAbs(r, 1) > 0 && pow(r, p) == b)
+                {
+                    b = std::move(r);
+                    e *= p;
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        if (e == 1)
+        {
+            return false;
+        }
+
+        b.mIsNegative = x.mIsNegative;
+        base = std::move(b);
+        exponent = e;
+        return true;
+    }
+
+    // Binary form: a little-endian 64-bit header holding twice the limb
+    // count, plus one for negative values, followed by the limbs as
+    // little-endian 32-bit words, least significant first. Zero is just
+    // the header.
+    std::size_t serializedSize() const
+    {
+        return SERIAL_HEADER_BYTES + mLimbs.size() * 4;
+    }
+
+    // Writes serializedSize() bytes to out and returns the end of them.
+    unsigned char *serialize(unsigned char *out) const
+    {
+        std::uint64_t header = std::uint64_t(mLimbs.size()) * 2 + (mIsNegative ? 1 : 0);
+
+        for (std::size_t b = 0; b < SERIAL_HEADER_BYTES; b++)
+        {
+            out[b] = static_cast<unsigned char>(header >> (8 * b));
+        }
+
+        storeLimbs(out + SERIAL_HEADER_BYTES, mLimbs.begin(), mLimbs.size());
+        return out + serializedSize();
+    }
+
+    std::string serialize() const
+    {
+        std::string s(serializedSize(), '\0');
+        serialize(reinterpret_cast<unsigned char *>(&s[0]));
+        return s;
+    }
+
+    // Reads the value at the start of a buffer written by serialize;
+    // throws if it is truncated or not in canonical form.
+    static BigInt deserialize(const void *data, std::size_t size);
+
+    static BigInt deserialize(const std::string &s)
+    {
+        return deserialize(s.data(), s.size());
+    }
+};
+
+// Formats into a local buffer and hands it to the stream in large chunks
+// rather than one digit or limb at a time.
+inline std::ostream &operator<<(std::ostream &out, const BigInt &x)
+{
+    const std::size_t CHUNK_LIMBS = 512;
+    char buf[CHUNK_LIMBS * BigInt::BASE_DIGITS + 16];
+    char *p = buf;
+
+    if (x.mLimbs.empty())
+    {
+        *p++ = '0';
+    }
+    else
+    {
+        if (x.mIsNegative)
+        {
+            *p++ = '-';
+        }
+
+        char top[BigInt::BASE_DIGITS];
+        char *t = top + BigInt::BASE_DIGITS;
+        for (BigInt::Limb limb = x.mLimbs.back(); limb != 0; limb /= 10)
+        {
+            *--t = char('0' + limb % 10);
+        }
+        p = std::copy(t, top + BigInt::BASE_DIGITS, p);
+
+        for (std::size_t i = x.mLimbs.size() - 1; i-- > 0;)
+        {
+            if (p + BigInt::BASE_DIGITS > buf + sizeof(buf))
+            {
+                out.write(buf, p - buf);
+                p = buf;
+            }
+
+            BigInt::Limb limb = x.mLimbs[i];
+            for (int j = BigInt::BASE_DIGITS - 1; j >= 0; j--)
+            {
+                p[j] = char('0' + limb % 10);
+                limb /= 10;
+            }
+            p += BigInt::BASE_DIGITS;
+        }
+    }
+
+    out.write(buf, p - buf);
+    return out;
+}
+
+inline std::istream &operator>>(std::istream &in, BigInt &x)
+{
+    char ch;
+
+    if (!(in >> ch))
+    {
+        return in;
+    }
+
+    if ((ch == '+' || ch == '-') && !std::isdigit(in.peek()))
+    {
+        in.setstate(std::ios_base::failbit);
+        return in;
+    }
+
+    if (!(std::isdigit(ch) || ch == '+' || ch == '-'))
+    {
+        in.putback(ch);
+        in.setstate(std::ios_base::failbit);
+        return in;
+    }
+
+    std::string s;
+
+    if (std::isdigit(ch) || ch == '-')
+    {
+        s += ch;
+    }
+
+    while (in.get(ch) && std::isdigit(ch))
+    {
+        s += ch;
+    }
+
+    x = BigInt(s);
+
+    if (!std::isdigit(ch))
+    {
+        in.putback(ch);
+        return in;
+    }
+
+    return in;
+}
+
+inline bool operator==(const BigInt &a, const BigInt &b)
+{
+    return BigInt::compare(a, b) == 0;
+}
+
+inline bool operator!=(const BigInt &a, const BigInt &b)
+{
+    return BigInt::compare(a, b) != 0;
+}
+
+inline bool operator<(const BigInt &a, const BigInt &b)
+{
+    return BigInt::compare(a, b) < 0;
+}
+
+inline bool operator>(const BigInt &a, const BigInt &b)
+{
+    return BigInt::compare(a, b) > 0;
+}
+
+inline bool operator>=(const BigInt &a, const BigInt &b)
+{
+    return BigInt::compare(a, b) >= 0;
+}
+
+inline bool operator<=(const BigInt &a, const BigInt &b)
+{
+    return BigInt::compare(a, b) <= 0;
+}
+
+inline BigInt BigInt::abs(const BigInt &x)
+{
+    BigInt r = x;
+    if (r.mIsNegative)
+        r.mIsNegative = false;
+    return r;
+}
+
+// Free-function form so generic code (e.g. Rational<BigInt>) picks it up
+// through argument-dependent lookup.
+inline BigInt gcd(const BigInt &a, const BigInt &b)
+{
+    return BigInt::gcd(a, b);
+}
+
+inline BigInt operator+(const BigInt &a, const BigInt &b)
+{
+    BigInt r;
+    r.mLimbs.reserve(std::max(a.mLimbs.size(), b.mLimbs.size()) + 1);
+    r = a;
+    r += b;
+    return r;
+}
+
+inline BigInt operator-(const BigInt &a, const BigInt &b)
+{
+    BigInt r;
+    r.mLimbs.reserve(std::max(a.mLimbs.size(), b.mLimbs.size()) + 1);
+    r = a;
+    r -= b;
+    return r;
+}
+
+inline BigInt operator*(const BigInt &a, const BigInt &b)
+{
+    BigInt r = BigInt::multiplyAbsValues(a, b);
+    r.mIsNegative = (a.mIsNegative != b.mIsNegative);
+    r.normalize();
+    return r;
+}
+
+inline BigInt operator/(const BigInt &a, const BigInt &b)
+{
+    BigInt q, r;
+    BigInt::divmod(a, b, q, r);
+    return q;
+}
+
+inline BigInt operator%(const BigInt &a, const BigInt &b)
+{
+    if (b.mIsNegative)
+    {
+        throw std::runtime_error("BigInt: modulus not positive");
+    }
+
+    BigInt q, r;
+    BigInt::divmod(a, b, q, r);
+    return r;
+}
+
+inline BigInt operator++(BigInt &x, int)
+{
+    BigInt old = x;
+    x += 1;
+    return old;
+}
+
+inline BigInt &operator++(BigInt &x)
+{
+    x += 1;
+    return x;
+}
+
+inline BigInt operator--(BigInt &x, int)
+{
+    BigInt old = x;
+    x -= 1;
+    return old;
+}
+
+inline BigInt &operator--(BigInt &x)
+{
+    x -= 1;
+    return x;
+}
+
+inline BigInt &operator+=(BigInt &a, const BigInt &b)
+{
+    BigInt::addInPlace(a, b, false);
+    return a;
+}
+
+inline BigInt &operator-=(BigInt &a, const BigInt &b)
+{
+    BigInt::addInPlace(a, b, true);
+    return a;
+}
+
+inline BigInt &operator*=(BigInt &a, const BigInt &b)
+{
+    if (&a != &b && b.mLimbs.size() == 1)
+    {
+        BigInt::multiplyAbsSmall(a, b.mLimbs[0]);
+        a.mIsNegative = (a.mIsNegative != b.mIsNegative);
+        a.normalize();
+        return a;
+    }
+
+    a = a * b;
+    return a;
+}
+
+inline BigInt &operator/=(BigInt &a, const BigInt &b)
+{
+    a = a / b;
+    return a;
+}
+
+inline BigInt &operator%=(BigInt &a, const BigInt &b)
+{
+    a = a % b;
+    return a;
+}
+
+inline BigInt operator-(BigInt x)
+{
+    x.mIsNegative = !x.mIsNegative;
+    x.normalize();
+    return x;
+}
+
+inline BigInt operator+(BigInt x)
+{
+    return x;
+}
+
+// Overloads for temporaries reuse the limbs of the rvalue operand, so a
+// chain like a + b + c allocates only for the first sum.
+
+inline BigInt operator+(BigInt &&a, const BigInt &b)
+{
+    a += b;
+    return std::move(a);
+}
+
+inline BigInt operator+(const BigInt &a, BigInt &&b)
+{
+    b += a;
+    return std::move(b);
+}
+
+inline BigInt operator+(BigInt &&a, BigInt &&b)
+{
+    a += b;
+    return std::move(a);
+}
+
+inline BigInt operator-(BigInt &&a, const BigInt &b)
+{
+    a -= b;
+    return std::move(a);
+}
+
+inline BigInt operator-(const BigInt &a, BigInt &&b)
+{
+    b -= a;
+    return -std::move(b);
+}
+
+inline BigInt operator-(BigInt &&a, BigInt &&b)
+{
+    a -= b;
+    return std::move(a);
+}
+
+inline BigInt operator*(BigInt &&a, const BigInt &b)
+{
+    a *= b;
+    return std::move(a);
+}
+
+inline BigInt operator*(const BigInt &a, BigInt &&b)
+{
+    b *= a;
+    return std::move(b);
+}
+
+inline BigInt operator*(BigInt &&a, BigInt &&b)
+{
+    a *= b;
+    return std::move(a);
+}
+
+// Mixed BigInt / machine integer operators. Values that fit in one limb
+// are handled directly on the limbs without building a BigInt operand.
+
+inline bool operator==(const BigInt &a, long long b)
+{
+    return BigInt::compare(a, b) == 0;
+}
+
+inline bool operator!=(const BigInt &a, long long b)
+{
+    return BigInt::compare(a, b) != 0;
+}
+
+inline bool operator<(const BigInt &a, long long b)
+{
+    return BigInt::compare(a, b) < 0;
+}
+
+inline bool operator>(const BigInt &a, long long b)
+{
+    return BigInt::compare(a, b) > 0;
+}
+
+inline bool operator<=(const BigInt &a, long long b)
+{
+    return BigInt::compare(a, b) <= 0;
+}
+
+inline bool operator>=(const BigInt &a, long long b)
+{
+    return BigInt::compare(a, b) >= 0;
+}
+
+inline bool operator==(long long a, const BigInt &b)
+{
+    return BigInt::compare(b, a) == 0;
+}
+
+inline bool operator!=(long long a, const BigInt &b)
+{
+    return BigInt::compare(b, a) != 0;
+}
+
+inline bool operator<(long long a, const BigInt &b)
+{
+    return BigInt::compare(b, a) > 0;
+}
+
+inline bool operator>(long long a, const BigInt &b)
+{
+    return BigInt::compare(b, a) < 0;
+}
+
+inline bool operator<=(long long a, const BigInt &b)
+{
+    return BigInt::compare(b, a) >= 0;
+}
+
+inline bool operator>=(long long a, const BigInt &b)
+{
+    return BigInt::compare(b, a) <= 0;
+}
+
+inline BigInt &operator+=(BigInt &a, long long b)
+{
+    if (!BigInt::fitsInLimb(b))
+    {
+        return a += BigInt(b);
+    }
+
+    BigInt::addSmall(a, b < 0, BigInt::Limb(BigInt::magnitude(b)));
+    return a;
+}
+
+inline BigInt &operator-=(BigInt &a, long long b)
+{
+    if (!BigInt::fitsInLimb(b))
+    {
+        return a -= BigInt(b);
+    }
+
+    BigInt::addSmall(a, b >= 0, BigInt::Limb(BigInt::magnitude(b)));
+    return a;
+}
+
+inline BigInt &operator*=(BigInt &a, long long b)
+{
+    if (!BigInt::fitsInLimb(b))
+    {
+        return a *= BigInt(b);
+    }
+
+    BigInt::multiplyAbsSmall(a, BigInt::Limb(BigInt::magnitude(b)));
+    a.mIsNegative = (a.mIsNegative != (b < 0));
+    a.normalize();
+    return a;
+}
+
+inline BigInt &operator/=(BigInt &a, long long b)
+{
+    if (b == 0)
+    {
+        throw std::runtime_error("division by zero occurred!");
+    }
+
+    if (!BigInt::fitsInLimb(b))
+    {
+        return a /= BigInt(b);
+    }
+
+    BigInt::divideAbsSmall(a, BigInt::Limb(BigInt::magnitude(b)));
+    a.mIsNegative = (a.mIsNegative != (b < 0));
+    a.normalize();
+    return a;
+}
+
+inline BigInt &operator%=(BigInt &a, long long b)
+{
+    if (b < 0)
+    {
+        throw std::runtime_error("BigInt: modulus not positive");
+    }
+
+    if (b == 0)
+    {
+        throw std::runtime_error("division by zero occurred!");
+    }
+
+    if (!BigInt::fitsInLimb(b))
     {
-        return BigInt::addAbsValues(a, BigInt::abs(b));
+        return a %= BigInt(b);
     }
 
-    if (a == b)
-        return BigInt(0);
+    BigInt::Limb rem = BigInt::modAbsSmall(a, BigInt::Limb(b));
+    a.mLimbs.assign(rem != 0 ? 1 : 0, rem);
+    a.normalize();
+    return a;
+}
 
+inline BigInt operator+(const BigInt &a, long long b)
+{
+    BigInt r = a;
+    r += b;
     return r;
 }
 
-inline BigInt operator*(const BigInt &a, const BigInt &b)
+inline BigInt operator+(long long a, const BigInt &b)
 {
-    BigInt r(0);
+    BigInt r = b;
+    r += a;
+    return r;
+}
 
-    if (a == 0 || b == 0)
-        return r;
+inline BigInt operator-(const BigInt &a, long long b)
+{
+    BigInt r = a;
+    r -= b;
+    return r;
+}
 
-    if (a == 1)
-        return b;
+inline BigInt operator-(long long a, const BigInt &b)
+{
+    BigInt r = -b;
+    r += a;
+    return r;
+}
 
-    if (b == 1)
-        return a;
+inline BigInt operator*(const BigInt &a, long long b)
+{
+    BigInt r = a;
+    r *= b;
+    return r;
+}
+
+inline BigInt operator*(long long a, const BigInt &b)
+{
+    BigInt r = b;
+    r *= a;
+    return r;
+}
+
+inline BigInt operator/(const BigInt &a, long long b)
+{
+    BigInt r = a;
+    r /= b;
+    return r;
+}
+
+inline BigInt operator%(const BigInt &a, long long b)
+{
+    if (b < 0)
+    {
+        throw std::runtime_error("BigInt: modulus not positive");
+    }
 
-    if ((!a.mIsNegative && !b.mIsNegative) || (a.mIsNegative && b.mIsNegative))
+    if (b == 0)
     {
-        return BigInt::multiplyAbsValues(a, b);
+        throw std::runtime_error("division by zero occurred!");
     }
 
-    if ((!a.mIsNegative && b.mIsNegative) || (a.mIsNegative && !b.mIsNegative))
+    if (!BigInt::fitsInLimb(b))
     {
-        r = BigInt::multiplyAbsValues(a, b);
-        r.mIsNegative = true;
+        return a % BigInt(b);
     }
 
+    BigInt r(BigInt::modAbsSmall(a, BigInt::Limb(b)));
+    r.mIsNegative = a.mIsNegative;
+    r.normalize();
     return r;
 }
 
-// To be fixed later
-inline BigInt operator/(const BigInt &a, const BigInt &b)
+inline BigInt operator+(BigInt &&a, long long b)
+{
+    a += b;
+    return std::move(a);
+}
+
+inline BigInt operator+(long long a, BigInt &&b)
 {
-    BigInt r(0);
+    b += a;
+    return std::move(b);
+}
 
-    if (b == 0)
+inline BigInt operator-(BigInt &&a, long long b)
+{
+    a -= b;
+    return std::move(a);
+}
+
+inline BigInt operator-(long long a, BigInt &&b)
+{
+    b -= a;
+    return -std::move(b);
+}
+
+inline BigInt operator*(BigInt &&a, long long b)
+{
+    a *= b;
+    return std::move(a);
+}
+
+inline BigInt operator*(long long a, BigInt &&b)
+{
+    b *= a;
+    return std::move(b);
+}
+
+inline BigInt operator/(BigInt &&a, long long b)
+{
+    a /= b;
+    return std::move(a);
+}
+
+// Arithmetic modulo a fixed positive m. Barrett's constant
+// floor(BASE^2k / m) is computed once, after which reducing anything below
+// BASE^2k (e.g. the product of two residues) costs two multiplications and
+// a subtraction instead of a long division. Results are always in [0, m);
+// add, sub and mul expect their operands to be in that range already.
+class BigInt::Modulus
+{
+    BigInt mValue;
+    BigInt mFactor;
+    std::size_t mLimbCount;
+
+    // |x| mod m for |x| < BASE^2k
+    BigInt barrett(const BigInt &x) const
     {
-        throw std::runtime_error("division by zero occurred!");
+        const std::size_t k = mLimbCount;
+
+        BigInt q = BigInt::slice(x, k - 1, k + 2) * mFactor;
+        q = BigInt::slice(q, k + 1, q.mLimbs.size());
+
+        // the estimate is at most two short, so 0 <= x - q * m < 3m
+        BigInt r = x;
+        r.mIsNegative = false;
+        BigInt::subAbsInPlace(r, q * mValue);
+        r.normalize();
+
+        while (BigInt::compareAbs(r, mValue) >= 0)
+        {
+            BigInt::subAbsInPlace(r, mValue);
+            r.normalize();
+        }
+
+        return r;
     }
-    if (a == 0)
+
+public:
+    explicit Modulus(const BigInt &m) : mValue(m), mLimbCount(m.mLimbs.size())
     {
-        return BigInt(0);
+        if (m.mIsNegative || m.mLimbs.empty())
+        {
+            throw std::runtime_error("BigInt: modulus not positive");
+        }
+
+        if (mLimbCount > 1)
+        {
+            BigInt power;
+            power.mLimbs.assign(2 * mLimbCount + 1, 0);
+            power.mLimbs.back() = 1;
+            mFactor = BigInt::divideAbsValues(power, mValue);
+        }
     }
-    if (a == b)
+
+    const BigInt &value() const
     {
-        return BigInt(1);
+        return mValue;
     }
-    if ((a.mIsNegative && b.mIsNegative) || !(a.mIsNegative || b.mIsNegative))
+
+    BigInt reduce(const BigInt &x) const
     {
-        if (a.mDigits.size() == b.mDigits.size())
+        BigInt r;
+
+        if (mLimbCount == 1)
         {
-            if (a > b)
-            {
-                return BigInt(1);
-            }
-            if (a < b)
-            {
-                return BigInt(0);
-            }
+            r = BigInt(BigInt::modAbsSmall(x, mValue.mLimbs[0]));
         }
-        if (a.mDigits.size() < b.mDigits.size())
+        else if (x.mLimbs.size() <= 2 * mLimbCount)
         {
-            return BigInt(0);
+            r = barrett(x);
         }
-        if (a.mDigits.size() > b.mDigits.size())
+        else
+        {
+            r = BigInt::modDivideAbsValues(x, mValue);
+        }
+
+        if (x.mIsNegative && !r.mLimbs.empty())
         {
-            return BigInt::divideAbsValues(BigInt::abs(a), BigInt::abs(b));
+            BigInt::subAbsFromInPlace(r, mValue);
+            r.normalize();
         }
+
+        return r;
     }
-    if (a.mIsNegative && !b.mIsNegative)
+
+    BigInt add(const BigInt &a, const BigInt &b) const
     {
-        if (BigInt::abs(a) < b)
+        BigInt r = a + b;
+
+        if (BigInt::compareAbs(r, mValue) >= 0)
         {
-            return BigInt(0);
+            BigInt::subAbsInPlace(r, mValue);
+            r.normalize();
         }
-        if (BigInt::abs(a) > b)
+
+        return r;
+    }
+
+    BigInt sub(const BigInt &a, const BigInt &b) const
+    {
+        BigInt r = a - b;
+
+        if (r.mIsNegative)
         {
-            r = BigInt::divideAbsValues(BigInt::abs(a), BigInt::abs(b));
-            r.mIsNegative = true;
-            return r;
+            r += mValue;
         }
+
+        return r;
+    }
+
+    BigInt mul(const BigInt &a, const BigInt &b) const
+    {
+        return reduce(a * b);
     }
-    if (!a.mIsNegative && b.mIsNegative)
+
+    // Left-to-right fixed-window exponentiation.
+    BigInt pow(const BigInt &base, const BigInt &exp) const
     {
-        if (a < BigInt::abs(b))
+        if (exp.mIsNegative)
         {
-            return BigInt(0);
+            throw std::runtime_error("BigInt: negative exponent");
         }
-        if (a > BigInt::abs(b))
+
+        // exponent bits, 30 at a time, least significant word first
+        std::vector<Limb> words;
+        BigInt e = exp;
+        while (!e.mLimbs.empty())
         {
-            r = BigInt::divideAbsValues(BigInt::abs(a), BigInt::abs(b));
-            r.mIsNegative = true;
-            return r;
+            words.push_back(BigInt::divideAbsSmall(e, Limb(1) << 30));
+        }
+
+        const std::size_t bits = words.size() * 30;
+        const std::size_t window = (bits <= 32) ? 1 : (bits <= 512) ? 4 : 5;
+
+        std::vector<BigInt> table(std::size_t(1) << window);
+        table[0] = reduce(BigInt(1));
+        table[1] = reduce(base);
+        for (std::size_t i = 2; i < table.size(); i++)
+        {
+            table[i] = mul(table[i - 1], table[1]);
+        }
+
+        BigInt result = table[0];
+
+        for (std::size_t top = (bits + window - 1) / window * window; top > 0; top -= window)
+        {
+            std::size_t digit = 0;
+
+            for (std::size_t bit = top; bit-- > top - window;)
+            {
+                result = mul(result, result);
+                bool set = bit < bits && (words[bit / 30] >> (bit % 30) & 1);
+                digit = digit * 2 + (set ? 1 : 0);
+            }
+
+            if (digit != 0)
+            {
+                result = mul(result, table[digit]);
+            }
         }
+
+        return result;
     }
-    return r;
+};
+
+inline BigInt BigInt::powMod(const BigInt &base, const BigInt &exp, const BigInt &mod)
+{
+    return Modulus(mod).pow(base, exp);
 }
 
-inline BigInt operator%(const BigInt &a, const BigInt &b)
+// Memoized factorials for callers that ask for many nearby n. A query is
+// answered from the closest cached m! <= n times (m + 1) ... n when that
+// range is short, and from scratch otherwise; either way the result is
+// cached, keeping at most capacity entries (the ones nearest the latest
+// query).
+class BigInt::FactorialTable
 {
-    BigInt r;
+    std::map<long long, BigInt> mCache;
+    std::size_t mCapacity;
+
+public:
+    explicit FactorialTable(std::size_t capacity = 64) : mCapacity(std::max<std::size_t>(capacity, 1))
+    {
+    }
 
-    if (a.mIsNegative && !b.mIsNegative)
+    BigInt factorial(long long n)
     {
-        r = BigInt::modDivideAbsValues(BigInt::abs(a), BigInt::abs(b));
-        r.mIsNegative = true;
+        if (n < 0)
+        {
+            throw std::runtime_error("BigInt: factorial of a negative number");
+        }
+
+        BigInt r;
+        auto it = mCache.upper_bound(n);
+
+        if (it != mCache.begin() && n - std::prev(it)->first <= std::max(n / 4, 64LL))
+        {
+            --it;
+            r = it->second;
+            if (it->first < n)
+            {
+                r *= BigInt::rangeProduct(DoubleLimb(it->first) + 1, DoubleLimb(n));
+            }
+        }
+        else
+        {
+            r = BigInt::factorial(n);
+        }
+
+        mCache[n] = r;
+
+        while (mCache.size() > mCapacity)
+        {
+            auto first = mCache.begin(), last = std::prev(mCache.end());
+            mCache.erase((n - first->first >= last->first - n) ? first : last);
+        }
+
         return r;
     }
-    if (b.mIsNegative)
+
+    std::size_t size() const
     {
-        throw std::runtime_error("BigInt: modulus not positive");
+        return mCache.size();
     }
 
-    return BigInt::modDivideAbsValues(a, b);
-}
+    void clear()
+    {
+        mCache.clear();
+    }
+};
 
-inline BigInt operator++(BigInt &x, int)
+// Read-only access to a serialized BigInt in place, e.g. in a memory
+// mapped file, without copying its limbs. The constructor checks only the
+// header against the buffer size; limb and compare trust the limbs, and
+// toBigInt checks them as it copies.
+class BigInt::View
 {
-    x = x + 1;
-    return x;
-}
+    const unsigned char *mLimbData;
+    std::size_t mLimbCount;
+    bool mIsNegative;
 
-inline BigInt &operator++(BigInt &x)
-{
-    x++;
-    return x;
-}
+public:
+    View(const void *data, std::size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
 
-inline BigInt operator--(BigInt &x, int)
-{
-    x = x - 1;
-    return x;
-}
+        if (size < BigInt::SERIAL_HEADER_BYTES)
+        {
+            throw std::runtime_error("BigInt: truncated serialized value");
+        }
 
-inline BigInt &operator--(BigInt &x)
-{
-    x--;
-    return x;
-}
+        std::uint64_t header = 0;
+        for (std::size_t b = BigInt::SERIAL_HEADER_BYTES; b-- > 0;)
+        {
+            header = header << 8 | bytes[b];
+        }
 
-inline BigInt &operator+=(BigInt &a, const BigInt &b)
-{
-    a = a + b;
-    return a;
-}
+        if (header / 2 > (size - BigInt::SERIAL_HEADER_BYTES) / 4)
+        {
+            throw std::runtime_error("BigInt: truncated serialized value");
+        }
 
-inline BigInt &operator-=(BigInt &a, const BigInt &b)
-{
-    a = a - b;
-    return a;
-}
+        mLimbData = bytes + BigInt::SERIAL_HEADER_BYTES;
+        mLimbCount = std::size_t(header / 2);
+        mIsNegative = (header & 1) != 0;
+    }
 
-inline BigInt &operator*=(BigInt &a, const BigInt &b)
-{
-    a = a * b;
-    return a;
-}
+    std::size_t limbCount() const
+    {
+        return mLimbCount;
+    }
 
-inline BigInt &operator/=(BigInt &a, const BigInt &b)
-{
-    a = a / b;
-    return a;
-}
+    bool isNegative() const
+    {
+        return mIsNegative;
+    }
 
-inline BigInt &operator%=(BigInt &a, const BigInt &b)
-{
-    a = a % b;
-    return a;
-}
+    // Bytes the value occupies, header included; the next value of a
+    // sequence starts this far after this one.
+    std::size_t byteSize() const
+    {
+        return BigInt::SERIAL_HEADER_BYTES + mLimbCount * 4;
+    }
 
-inline BigInt operator-(const BigInt x)
-{
-    BigInt r = x;
-    r.mIsNegative = (r.mIsNegative ? false : true);
-    return r;
-}
+    // i-th limb, least significant first.
+    Limb limb(std::size_t i) const
+    {
+        Limb v;
+        BigInt::loadLimbs(&v, mLimbData + 4 * i, 1);
+        return v;
+    }
+
+    // -1, 0 or 1 as the viewed value is less than, equal to or greater
+    // than x.
+    int compare(const BigInt &x) const
+    {
+        if (mIsNegative != x.mIsNegative)
+        {
+            return mIsNegative ? -1 : 1;
+        }
+
+        int sign = mIsNegative ? -1 : 1;
+
+        if (mLimbCount != x.mLimbs.size())
+        {
+            return mLimbCount < x.mLimbs.size() ? -sign : sign;
+        }
+
+        for (std::size_t i = mLimbCount; i-- > 0;)
+        {
+            Limb v = limb(i);
+            if (v != x.mLimbs[i])
+            {
+                return v < x.mLimbs[i] ? -sign : sign;
+            }
+        }
 
-inline BigInt operator+(const BigInt x)
+        return 0;
+    }
+
+    BigInt toBigInt() const
+    {
+        BigInt x;
+        x.mLimbs.resize(mLimbCount);
+        BigInt::loadLimbs(x.mLimbs.begin(), mLimbData, mLimbCount);
+
+        Limb highest = 0;
+        for (std::size_t i = 0; i < mLimbCount; i++)
+        {
+            highest = std::max(highest, x.mLimbs[i]);
+        }
+
+        if (highest >= BigInt::BASE || (mLimbCount != 0 && x.mLimbs.back() == 0) ||
+            (mLimbCount == 0 && mIsNegative))
+        {
+            throw std::runtime_error("BigInt: malformed serialized value");
+        }
+
+        x.mIsNegative = mIsNegative;
+        return x;
+    }
+};
+
+inline BigInt BigInt::deserialize(const void *data, std::size_t size)
 {
-    BigInt r = x;
-    return r;
-}
\ No newline at end of file
+    return View(data, size).toBigInt();
+}
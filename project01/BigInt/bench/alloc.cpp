@@ -0,0 +1,42 @@
+// Replacement global operator new and delete that count allocations. They
+// live in their own translation unit so that the compiler cannot inline
+// the malloc/free pair into main.cpp and pair it with the library's own
+// operator new.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "alloc.hpp"
+
+using namespace std;
+
+// operator new runs on the worker threads too under --threads.
+static atomic<long long> gAllocations(0);
+
+long long heapAllocations()
+{
+    return gAllocations.load(memory_order_relaxed);
+}
+
+void *operator new(size_t n)
+{
+    gAllocations.fetch_add(1, memory_order_relaxed);
+
+    if (void *p = malloc(n ? n : 1))
+    {
+        return p;
+    }
+
+    throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+// Number of calls to the global operator new so far, on any thread.
+long long heapAllocations();
@@ -0,0 +1,254 @@
+// Scaling benchmark for BigInt: times add, sub, mul, divmod, parse, print,
+// serialize and deserialize for operands from 10 to 10^6 decimal digits
+// and reports ns/op, heap allocations/op and the limb blocks/op taken
+// from BigInt's block cache and, of those, fresh from the heap, both on
+// stdout and as CSV.
+//
+// usage: ./main [csv-file] [max-digits] [max-divmod-digits]
+//        ./main --threads [csv-file] [max-threads]
+//
+// The second form times multiplication of 10^4 to 10^6 digit operands
+// with BigInt::setParallelism set to 1, 2, 4, ... threads and reports
+// the speedup over one thread.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../BigInt.hpp"
+#include "alloc.hpp"
+
+using namespace std;
+
+// Discards everything written to it, so print timings measure formatting
+// rather than string growth.
+struct NullBuffer : streambuf
+{
+    int overflow(int c) override
+    {
+        return c;
+    }
+
+    streamsize xsputn(const char *, streamsize n) override
+    {
+        return n;
+    }
+};
+
+struct Result
+{
+    string workload;
+    string op;
+    int digits;
+    long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    // BigInt::allocationStats of the calling thread
+    double limbBlocksPerOp;
+    double limbHeapPerOp;
+};
+
+template <typename F>
+Result measure(const string &workload, const string &op, int digits, F f)
+{
+    using Clock = chrono::steady_clock;
+    const auto minTime = chrono::milliseconds(200);
+
+    f();
+
+    long long iterations = 0;
+    long long allocsBefore = heapAllocations();
+    BigInt::resetAllocationStats();
+    auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+
+    do
+    {
+        f();
+        iterations++;
+        elapsed = Clock::now() - start;
+    } while (elapsed < minTime);
+
+    double ns = chrono::duration<double, nano>(elapsed).count();
+    BigInt::AllocationStats limbs = BigInt::allocationStats();
+
+    return {workload, op, digits, iterations, ns / iterations,
+            double(heapAllocations() - allocsBefore) / iterations,
+            double(limbs.allocations) / iterations, double(limbs.heapAllocations) / iterations};
+}
+
+string toString(const BigInt &x)
+{
+    ostringstream sout;
+    sout << x;
+    return sout.str();
+}
+
+struct Workload
+{
+    string name;
+    string digits;
+};
+
+// Decimal sources of at least maxDigits digits taken from the UVA jobs
+// (p623 / p324 factorials, p495 Fibonacci numbers, p10523 powers), built
+// with the library's own factorial, fibonacci and pow.
+vector<Workload> buildWorkloads(int maxDigits)
+{
+    vector<Workload> workloads;
+
+    long long n = 10;
+    BigInt f;
+    do
+    {
+        n *= 2;
+        f = BigInt::factorial(n);
+    } while (int(toString(f).size()) < maxDigits * 2);
+    workloads.push_back({"factorial", toString(f)});
+
+    // F(n) has about 0.209 * n digits
+    workloads.push_back({"fibonacci", toString(BigInt::fibonacci(maxDigits * 2 * 5))});
+
+    // 150^n has about 2.18 * n digits
+    workloads.push_back({"power", toString(BigInt::pow(150, maxDigits + 1))});
+
+    return workloads;
+}
+
+int scaling(const string &csvPath, unsigned maxThreads)
+{
+    vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2)
+    {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    cerr << "building operands...\n";
+    vector<Workload> workloads = buildWorkloads(1000000);
+    const Workload &x = workloads[0], &y = workloads[1];
+
+    ofstream csv(csvPath);
+    csv << "digits,threads,iterations,ns_per_op,speedup\n";
+    printf("%8s %8s %12s %16s %8s\n", "digits", "threads", "iterations", "ns/op", "speedup");
+
+    for (int d : {10000, 30000, 100000, 300000, 1000000})
+    {
+        BigInt a(x.digits.substr(0, d)), b(y.digits.substr(0, d));
+        double base = 0;
+
+        for (unsigned t : threadCounts)
+        {
+            BigInt::setParallelism(t);
+            Result r = measure("mul", "mul", d, [&]
+                               { BigInt p = a * b; });
+
+            if (t == 1)
+            {
+                base = r.nsPerOp;
+            }
+
+            csv << d << "," << t << "," << r.iterations << "," << r.nsPerOp << "," << base / r.nsPerOp << "\n";
+            printf("%8d %8u %12lld %16.1f %8.2f\n", d, t, r.iterations, r.nsPerOp, base / r.nsPerOp);
+        }
+    }
+
+    BigInt::setParallelism(1);
+    cerr << "wrote " << csvPath << "\n";
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && string(argv[1]) == "--threads")
+    {
+        unsigned hardware = max(1u, thread::hardware_concurrency());
+        return scaling(argc > 2 ? argv[2] : "scaling.csv", argc > 3 ? unsigned(atoi(argv[3])) : hardware);
+    }
+
+    string csvPath = argc > 1 ? argv[1] : "bench.csv";
+    int maxDigits = argc > 2 ? atoi(argv[2]) : 1000000;
+    int maxDivmodDigits = argc > 3 ? atoi(argv[3]) : 100000;
+
+    vector<int> sizes;
+    for (int d = 10; d <= maxDigits; d *= 10)
+    {
+        sizes.push_back(d);
+        if (d * 3 <= maxDigits)
+        {
+            sizes.push_back(d * 3);
+        }
+    }
+
+    cerr << "building operands...\n";
+    vector<Workload> workloads = buildWorkloads(maxDigits);
+
+    vector<Result> results;
+    NullBuffer nullBuffer;
+    ostream nullOut(&nullBuffer);
+
+    for (const auto &w : workloads)
+    {
+        const Workload &other = workloads[(&w - &workloads[0] + 1) % workloads.size()];
+
+        for (int d : sizes)
+        {
+            string as = w.digits.substr(0, d);
+            string bs = other.digits.substr(0, d);
+            BigInt a(as), b(bs);
+            BigInt wide(w.digits.substr(0, 2 * d)), half(other.digits.substr(0, d / 2 + 1));
+
+            results.push_back(measure(w.name, "add", d, [&]
+                                      { BigInt r = a + b; }));
+            results.push_back(measure(w.name, "sub", d, [&]
+                                      { BigInt r = b - a; }));
+            results.push_back(measure(w.name, "mul", d, [&]
+                                      { BigInt r = a * b; }));
+
+            if (d <= maxDivmodDigits)
+            {
+                // 2d-digit dividend by a d-digit divisor, and d by d/2
+                BigInt q, r;
+                results.push_back(measure(w.name, "divmod", d, [&]
+                                          { BigInt::divmod(wide, b, q, r); }));
+                results.push_back(measure(w.name, "divmod-half", d, [&]
+                                          { BigInt::divmod(a, half, q, r); }));
+            }
+
+            results.push_back(measure(w.name, "parse", d, [&]
+                                      { BigInt r(as); }));
+            results.push_back(measure(w.name, "print", d, [&]
+                                      { nullOut << a; }));
+
+            // binary round trip, for comparison with parse and print
+            vector<unsigned char> buffer(a.serializedSize());
+            results.push_back(measure(w.name, "serialize", d, [&]
+                                      { a.serialize(buffer.data()); }));
+            results.push_back(measure(w.name, "deserialize", d, [&]
+                                      { BigInt r = BigInt::deserialize(buffer.data(), buffer.size()); }));
+
+            cerr << w.name << " " << d << " digits done\n";
+        }
+    }
+
+    ofstream csv(csvPath);
+    csv << "workload,op,digits,iterations,ns_per_op,allocs_per_op,limb_blocks_per_op,limb_heap_per_op\n";
+
+    printf("%-10s %-12s %8s %12s %16s %10s %10s %10s\n", "workload", "op", "digits", "iterations", "ns/op",
+           "allocs/op", "blocks/op", "fresh/op");
+    for (const auto &r : results)
+    {
+        csv << r.workload << "," << r.op << "," << r.digits << "," << r.iterations << ","
+            << r.nsPerOp << "," << r.allocsPerOp << "," << r.limbBlocksPerOp << "," << r.limbHeapPerOp << "\n";
+        printf("%-10s %-12s %8d %12lld %16.1f %10.2f %10.2f %10.2f\n", r.workload.c_str(), r.op.c_str(), r.digits,
+               r.iterations, r.nsPerOp, r.allocsPerOp, r.limbBlocksPerOp, r.limbHeapPerOp);
+    }
+
+    cerr << "wrote " << csvPath << "\n";
+}
@@ -2,6 +2,8 @@
 #include "../../doctest/doctest.h"
 #include <vector>
 #include <string>
+#include <random>
+#include <thread>
 
 #include "BigInt.hpp"
 
@@ -1301,4 +1303,793 @@ TEST_CASE("Unary minus and plus")
         REQUIRE(sout.str() == "-144");
         REQUIRE(a == -144);
     }
-}
\ No newline at end of file
+}
+
+BigInt randomBigInt(mt19937 &gen, int digits)
+{
+    string s(digits, '0');
+
+    for (auto &c : s)
+    {
+        c = char('0' + gen() % 10);
+    }
+
+    s[0] = char('1' + gen() % 9);
+
+    return BigInt(s);
+}
+
+TEST_CASE("Multiplication algorithms")
+{
+    mt19937 gen(2022);
+
+    SUBCASE("karatsuba matches schoolbook")
+    {
+        for (int digits : {450, 800, 1500, 2700})
+        {
+            BigInt a = randomBigInt(gen, digits);
+            BigInt b = randomBigInt(gen, digits - 7);
+            REQUIRE(BigInt::karatsubaMultiply(a, b) == BigInt::schoolbookMultiply(a, b));
+        }
+    }
+
+    SUBCASE("toom-3 matches schoolbook")
+    {
+        for (int digits : {450, 800, 1500, 4000})
+        {
+            BigInt a = randomBigInt(gen, digits);
+            BigInt b = randomBigInt(gen, digits - 100);
+            REQUIRE(BigInt::toom3Multiply(a, b) == BigInt::schoolbookMultiply(a, b));
+        }
+    }
+
+    SUBCASE("ntt matches schoolbook")
+    {
+        for (int digits : {100, 1000, 6000, 20000})
+        {
+            BigInt a = randomBigInt(gen, digits);
+            BigInt b = randomBigInt(gen, digits / 2 + 1);
+            REQUIRE(BigInt::nttMultiply(a, b) == BigInt::schoolbookMultiply(a, b));
+        }
+    }
+
+    SUBCASE("all nines")
+    {
+        BigInt a(string(5000, '9'));
+        BigInt b(string(4000, '9'));
+        REQUIRE(BigInt::karatsubaMultiply(a, b) == BigInt::schoolbookMultiply(a, b));
+        REQUIRE(BigInt::toom3Multiply(a, b) == BigInt::schoolbookMultiply(a, b));
+        REQUIRE(BigInt::nttMultiply(a, b) == BigInt::schoolbookMultiply(a, b));
+    }
+
+    SUBCASE("unbalanced operands")
+    {
+        BigInt a = randomBigInt(gen, 20000);
+        BigInt b = randomBigInt(gen, 700);
+        REQUIRE(a * b == BigInt::schoolbookMultiply(a, b));
+        REQUIRE(-a * b == -BigInt::schoolbookMultiply(a, b));
+    }
+
+    SUBCASE("product of large values")
+    {
+        BigInt a = randomBigInt(gen, 9000);
+        BigInt b = randomBigInt(gen, 8000);
+        REQUIRE(a * b == BigInt::schoolbookMultiply(a, b));
+        REQUIRE((a * b) / b == a);
+    }
+}
+
+TEST_CASE("Divmod")
+{
+    BigInt q, r;
+
+    SUBCASE("positive / positive")
+    {
+        BigInt::divmod(BigInt("12345"), BigInt("13"), q, r);
+        REQUIRE(q == 949);
+        REQUIRE(r == 8);
+    }
+
+    SUBCASE("signs follow truncating division")
+    {
+        BigInt::divmod(BigInt("-12345"), BigInt("13"), q, r);
+        REQUIRE(q == -949);
+        REQUIRE(r == -8);
+
+        BigInt::divmod(BigInt("12345"), BigInt("-13"), q, r);
+        REQUIRE(q == -949);
+        REQUIRE(r == 8);
+
+        BigInt::divmod(BigInt("-12345"), BigInt("-13"), q, r);
+        REQUIRE(q == 949);
+        REQUIRE(r == -8);
+    }
+
+    SUBCASE("division by zero")
+    {
+        REQUIRE_THROWS_AS(BigInt::divmod(BigInt("1"), BigInt("0"), q, r), runtime_error);
+    }
+
+    SUBCASE("large operands")
+    {
+        mt19937 gen(10494);
+
+        for (int digits : {20, 200, 2000, 9000})
+        {
+            BigInt a = randomBigInt(gen, digits * 2 + 5);
+            BigInt b = randomBigInt(gen, digits);
+            BigInt::divmod(a, b, q, r);
+            REQUIRE(q * b + r == a);
+            REQUIRE(r < b);
+            REQUIRE(r >= 0);
+        }
+    }
+
+    SUBCASE("output aliases an input")
+    {
+        BigInt a("1000000000000000000000000000007");
+        BigInt b("1000000007");
+        BigInt::divmod(a, b, a, b);
+        REQUIRE(a == BigInt("999999993000000048999"));
+        REQUIRE(b == BigInt("999657014"));
+    }
+}
+
+TEST_CASE("Operators with machine integers")
+{
+    ostringstream sout;
+
+    SUBCASE("construction from long long")
+    {
+        sout << BigInt(9223372036854775807LL) << " " << BigInt(-9223372036854775807LL - 1);
+        REQUIRE(sout.str() == "9223372036854775807 -9223372036854775808");
+    }
+
+    SUBCASE("addition and subtraction")
+    {
+        BigInt a("999999999999999999");
+        REQUIRE(a + 1 == BigInt("1000000000000000000"));
+        REQUIRE(1 + a == BigInt("1000000000000000000"));
+        REQUIRE(BigInt("-5") + 7 == 2);
+        REQUIRE(BigInt("5") - 7 == -2);
+        REQUIRE(7 - BigInt("5") == 2);
+        REQUIRE(BigInt("1000000000") - 1 == 999999999);
+    }
+
+    SUBCASE("multiplication")
+    {
+        BigInt a("123456789123456789");
+        REQUIRE(a * 1000 == BigInt("123456789123456789000"));
+        REQUIRE(-3 * a == BigInt("-370370367370370367"));
+        REQUIRE(a * 0 == 0);
+        REQUIRE(a * 4000000000LL == BigInt("493827156493827156000000000"));
+    }
+
+    SUBCASE("division and remainder")
+    {
+        BigInt a("1481481468");
+        REQUIRE(a / 12 == 123456789);
+        REQUIRE(BigInt("-12345") / 13 == -949);
+        REQUIRE(BigInt("12345") % 13 == 8);
+        REQUIRE(BigInt("-5") % 10 == -5);
+        REQUIRE_THROWS_AS(a / 0, runtime_error);
+        REQUIRE_THROWS_AS(a % -10, runtime_error);
+    }
+
+    SUBCASE("compound assignment")
+    {
+        BigInt a("-1");
+        a += 2;
+        REQUIRE(a == 1);
+        a -= 3;
+        REQUIRE(a == -2);
+        a *= -50;
+        REQUIRE(a == 100);
+        a /= 7;
+        REQUIRE(a == 14);
+        a %= 5;
+        REQUIRE(a == 4);
+    }
+
+    SUBCASE("comparison")
+    {
+        BigInt a("2147483648");
+        REQUIRE(a > 2147483647);
+        REQUIRE(2147483647 < a);
+        REQUIRE(BigInt("-3") < -2);
+        REQUIRE(BigInt("18446744073709551616") > 9223372036854775807LL);
+        REQUIRE(BigInt("-18446744073709551616") < -9223372036854775807LL);
+        REQUIRE(BigInt() == 0);
+    }
+}
+
+TEST_CASE("In-place and rvalue operators")
+{
+    SUBCASE("operand aliases the target")
+    {
+        BigInt a("999999999999999999999");
+        a += a;
+        REQUIRE(a == BigInt("1999999999999999999998"));
+        a -= a;
+        REQUIRE(a == 0);
+        BigInt b("-12345678901234567890");
+        b *= b;
+        REQUIRE(b == BigInt("152415787532388367501905199875019052100"));
+    }
+
+    SUBCASE("sign changes in place")
+    {
+        BigInt a("5");
+        a -= BigInt("1000000000000");
+        REQUIRE(a == BigInt("-999999999995"));
+        a += BigInt("999999999995");
+        REQUIRE(a == 0);
+        a -= BigInt("-7");
+        REQUIRE(a == 7);
+    }
+
+    SUBCASE("chains of temporaries")
+    {
+        BigInt a("999999999"), b("1"), c("-2000000000");
+        REQUIRE(a + b + c == -1000000000);
+        REQUIRE(a - (b + c) == BigInt("2999999998"));
+        REQUIRE((a + b) - (c + b) == BigInt("2999999999"));
+        REQUIRE(5 - (a + b) == -999999995);
+        REQUIRE((a + b) * 3 == BigInt("3000000000"));
+        REQUIRE((a + b) * (a - b) == a * a - b * b);
+    }
+
+    SUBCASE("postfix returns the previous value")
+    {
+        BigInt a("41");
+        REQUIRE(a++ == 41);
+        REQUIRE(a == 42);
+        REQUIRE(a-- == 42);
+        REQUIRE(a == 41);
+    }
+
+    SUBCASE("moved-from value is zero")
+    {
+        BigInt a("-123456789123456789");
+        BigInt b = std::move(a);
+        REQUIRE(b == BigInt("-123456789123456789"));
+        REQUIRE(a == 0);
+        a = b;
+        REQUIRE(a == b);
+    }
+}
+
+TEST_CASE("compareAbs and compare")
+{
+    REQUIRE(BigInt::compareAbs(BigInt("-5"), BigInt("3")) == 1);
+    REQUIRE(BigInt::compareAbs(BigInt("3"), BigInt("-5")) == -1);
+    REQUIRE(BigInt::compareAbs(BigInt("-1000000000"), BigInt("1000000000")) == 0);
+    REQUIRE(BigInt::compareAbs(BigInt("1000000000"), BigInt("999999999")) == 1);
+    REQUIRE(BigInt::compareAbs(BigInt(), BigInt()) == 0);
+
+    REQUIRE(BigInt::compare(BigInt("-5"), BigInt("3")) == -1);
+    REQUIRE(BigInt::compare(BigInt("-5"), BigInt("-3")) == -1);
+    REQUIRE(BigInt::compare(BigInt("-3"), BigInt("-5")) == 1);
+    REQUIRE(BigInt::compare(BigInt("123456789123456789"), BigInt("123456789123456789")) == 0);
+}
+
+TEST_CASE("Values growing past the inline limbs")
+{
+    BigInt a("999999999999999999999999999999999999");
+    BigInt b = a;
+
+    a += 1;
+    REQUIRE(a == BigInt("1000000000000000000000000000000000000"));
+    REQUIRE(b == BigInt("999999999999999999999999999999999999"));
+
+    BigInt c = std::move(a);
+    a = b;
+    c -= 1;
+    REQUIRE(c == a);
+
+    c -= a;
+    REQUIRE(c == 0);
+    c += 5;
+    REQUIRE(c == 5);
+}
+
+TEST_CASE("Long carry and borrow chains")
+{
+    // Lengths around multiples of the eight-limb vector step
+    for (int limbs : {15, 16, 17, 23, 24, 25, 64, 200, 1001})
+    {
+        string nines(limbs * 9, '9');
+        BigInt all(nines), power("1" + string(limbs * 9, '0'));
+
+        REQUIRE(all + 1 == power);
+        REQUIRE(power - 1 == all);
+        REQUIRE(power - all == 1);
+
+        BigInt x = all;
+        x += all;
+        REQUIRE(x == power * 2 - 2);
+        x -= all;
+        REQUIRE(x == all);
+
+        // A chain that stops halfway through a vector
+        int half = limbs * 9 / 2;
+        BigInt mixed("1" + string(half, '0') + string(half, '9'));
+        BigInt next("1" + string(half - 1, '0') + "1" + string(half, '0'));
+        REQUIRE(mixed + 1 == next);
+        REQUIRE(next - 1 == mixed);
+    }
+
+    mt19937 gen(18);
+    for (int digits : {150, 1000, 9000})
+    {
+        BigInt a = randomBigInt(gen, digits), b = randomBigInt(gen, digits);
+        BigInt sum = a + b, difference = a - b;
+
+        REQUIRE(sum - b == a);
+        REQUIRE(difference + b == a);
+        REQUIRE(sum + difference == a * 2);
+        REQUIRE(-difference == b - a);
+    }
+}
+
+TEST_CASE("Decimal conversion of long values")
+{
+    SUBCASE("leading zeros and signed zero")
+    {
+        REQUIRE(BigInt("0000000000000000000123") == 123);
+        REQUIRE(BigInt("  -000123") == -123);
+        ostringstream sout;
+        sout << BigInt("-0") << " " << BigInt("+000");
+        REQUIRE(sout.str() == "0 0");
+    }
+
+    SUBCASE("round trip through the stream operators")
+    {
+        mt19937 gen(9);
+        BigInt x = randomBigInt(gen, 25000);
+        ostringstream digits;
+        digits << x;
+        REQUIRE(digits.str().size() == 25000);
+
+        ostringstream sout;
+        sout << -x;
+        REQUIRE(sout.str() == "-" + digits.str());
+
+        istringstream sinp(sout.str() + " tail");
+        BigInt y;
+        sinp >> y;
+        REQUIRE(y == -x);
+    }
+}
+
+TEST_CASE("Modular arithmetic")
+{
+    SUBCASE("Modulus agrees with the remainder operator")
+    {
+        mt19937 gen(11);
+        for (int digits : {5, 18, 40, 200, 1000})
+        {
+            BigInt::Modulus m(randomBigInt(gen, digits));
+            for (int i = 0; i < 20; i++)
+            {
+                BigInt a = randomBigInt(gen, digits) % m.value();
+                BigInt b = randomBigInt(gen, digits - 1);
+                REQUIRE(m.mul(a, b) == a * b % m.value());
+                REQUIRE(m.add(a, b) == (a + b) % m.value());
+                REQUIRE(m.sub(b, a) == (b - a + m.value()) % m.value());
+                REQUIRE(m.reduce(randomBigInt(gen, 3 * digits)) >= 0);
+            }
+        }
+    }
+
+    SUBCASE("reduce of negative and large values")
+    {
+        BigInt::Modulus m(BigInt("1000000000000000000007"));
+        REQUIRE(m.reduce(BigInt("-1")) == BigInt("1000000000000000000006"));
+        REQUIRE(m.reduce(BigInt("-1000000000000000000007")) == 0);
+        REQUIRE(m.reduce(BigInt("1000000000000000000007") * BigInt("123456789123456789123456789") + 5) == 5);
+    }
+
+    SUBCASE("powMod")
+    {
+        BigInt p("170141183460469231731687303715884105727"); // 2^127 - 1
+        REQUIRE(BigInt::powMod(3, p - 1, p) == 1);
+        REQUIRE(BigInt::powMod(2, 127, p) == 1);
+        REQUIRE(BigInt::powMod(-2, 3, 10) == 2);
+        REQUIRE(BigInt::powMod(7, 0, 13) == 1);
+        REQUIRE(BigInt::powMod(7, 0, 1) == 0);
+
+        mt19937 gen(12);
+        BigInt base = randomBigInt(gen, 30), mod = randomBigInt(gen, 25), expected = 1;
+        for (int e = 0; e < 200; e++)
+        {
+            REQUIRE(BigInt::powMod(base, e, mod) == expected);
+            expected = expected * base % mod;
+        }
+
+        REQUIRE_THROWS(BigInt::powMod(2, -1, 7));
+        REQUIRE_THROWS(BigInt::powMod(2, 3, 0));
+        REQUIRE_THROWS(BigInt::Modulus(BigInt(-7)));
+    }
+}
+
+TEST_CASE("gcd and extendedGcd")
+{
+    SUBCASE("small and signed values")
+    {
+        REQUIRE(BigInt::gcd(0, 0) == 0);
+        REQUIRE(BigInt::gcd(0, -15) == 15);
+        REQUIRE(BigInt::gcd(-12, 18) == 6);
+        REQUIRE(gcd(BigInt(17), BigInt(5)) == 1);
+
+        BigInt x, y;
+        REQUIRE(BigInt::extendedGcd(240, -46, x, y) == 2);
+        REQUIRE(240 * x - 46 * y == 2);
+        REQUIRE(BigInt::extendedGcd(0, 7, x, y) == 7);
+        REQUIRE(7 * y == 7);
+    }
+
+    SUBCASE("common factor of long values")
+    {
+        mt19937 gen(13);
+        for (int digits : {10, 19, 50, 400, 3000})
+        {
+            BigInt g = randomBigInt(gen, digits / 2 + 1);
+            BigInt a = randomBigInt(gen, digits) * g, b = randomBigInt(gen, digits + 3) * g;
+
+            BigInt d = BigInt::gcd(a, b);
+            REQUIRE(d % g == 0);
+            REQUIRE(BigInt::gcd(a / d, b / d) == 1);
+
+            BigInt x, y;
+            REQUIRE(BigInt::extendedGcd(a, -b, x, y) == d);
+            REQUIRE(a * x - b * y == d);
+        }
+    }
+
+    SUBCASE("consecutive Fibonacci numbers")
+    {
+        BigInt f0 = 0, f1 = 1;
+        for (int i = 0; i < 2000; i++)
+        {
+            f0 += f1;
+            std::swap(f0, f1);
+        }
+        REQUIRE(BigInt::gcd(f1, f0) == 1);
+    }
+}
+
+TEST_CASE("factorial and binomial")
+{
+    SUBCASE("factorial matches the running product")
+    {
+        BigInt running(1);
+        for (int n = 0; n <= 1200; n++)
+        {
+            if (n > 0)
+                running *= n;
+            REQUIRE(BigInt::factorial(n) == running);
+        }
+
+        REQUIRE_THROWS(BigInt::factorial(-1));
+    }
+
+    SUBCASE("binomial matches Pascal's triangle")
+    {
+        vector<BigInt> row(1, BigInt(1));
+        for (int n = 0; n <= 300; n++)
+        {
+            for (int k = 0; k <= n; k++)
+            {
+                REQUIRE(BigInt::binomial(n, k) == row[k]);
+            }
+
+            vector<BigInt> next(n + 2, BigInt(1));
+            for (int k = 1; k <= n; k++)
+            {
+                next[k] = row[k - 1] + row[k];
+            }
+            row.swap(next);
+        }
+
+        REQUIRE(BigInt::binomial(5, -1) == 0);
+        REQUIRE(BigInt::binomial(5, 6) == 0);
+        REQUIRE(BigInt::binomial(1000000000000LL, 3) == BigInt("166666666666166666666667000000000000"));
+        REQUIRE(BigInt::binomial(1000, 500) % BigInt("100000000000000000000") == BigInt("96905863799821216320"));
+        REQUIRE(BigInt::binomial(20000, 7000) * BigInt::factorial(7000) * BigInt::factorial(13000) == BigInt::factorial(20000));
+    }
+
+    SUBCASE("memoized table")
+    {
+        BigInt::FactorialTable table(4);
+        for (int n : {500, 510, 505, 2000, 499, 3000, 0, 2500, 510})
+        {
+            REQUIRE(table.factorial(n) == BigInt::factorial(n));
+            REQUIRE(table.size() <= 4);
+        }
+    }
+}
+
+TEST_CASE("fibonacci and linear recurrences")
+{
+    SUBCASE("fibonacci matches the iteration")
+    {
+        BigInt a, b(1);
+        for (int n = 0; n <= 1500; n++)
+        {
+            REQUIRE(BigInt::fibonacci(n) == a);
+            REQUIRE(BigInt::fibonacci(-n) == ((n % 2 == 0 && n > 0) ? -a : a));
+            a += b;
+            std::swap(a, b);
+        }
+    }
+
+    SUBCASE("large indices")
+    {
+        // gcd(F(m), F(n)) = F(gcd(m, n))
+        REQUIRE(BigInt::gcd(BigInt::fibonacci(300000), BigInt::fibonacci(125000)) == BigInt::fibonacci(25000));
+        REQUIRE(BigInt::fibonacci(100000) % 1000000 == 746875);
+    }
+
+    SUBCASE("linearRecurrence")
+    {
+        vector<BigInt> fibCoeffs{1, 1}, fibStart{0, 1};
+        for (int n : {0, 1, 2, 10, 99, 1000, 4321})
+        {
+            REQUIRE(BigInt::linearRecurrence(fibCoeffs, fibStart, n) == BigInt::fibonacci(n));
+        }
+
+        // a(n) = 2 a(n-1) - a(n-2) + 3 a(n-3)
+        vector<BigInt> coeffs{2, -1, 3}, terms{5, -7, 11};
+        for (int n = 3; n <= 400; n++)
+        {
+            terms.push_back(2 * terms[n - 1] - terms[n - 2] + 3 * terms[n - 3]);
+        }
+        for (int n = 0; n <= 400; n++)
+        {
+            REQUIRE(BigInt::linearRecurrence(coeffs, {5, -7, 11}, n) == terms[n]);
+        }
+
+        REQUIRE(BigInt::linearRecurrence({7}, {3}, 20) == 3 * BigInt("79792266297612001"));
+        REQUIRE_THROWS(BigInt::linearRecurrence({1, 1}, {0}, 5));
+    }
+}
+
+TEST_CASE("Roots and perfect powers")
+{
+    SUBCASE("isqrt brackets the square root")
+    {
+        mt19937 gen(14);
+        for (int digits : {1, 5, 9, 18, 19, 40, 300, 2000})
+        {
+            for (int i = 0; i < 10; i++)
+            {
+                BigInt x = randomBigInt(gen, digits);
+                BigInt r = BigInt::isqrt(x);
+                REQUIRE(r * r <= x);
+                REQUIRE((r + 1) * (r + 1) > x);
+            }
+        }
+
+        REQUIRE(BigInt::isqrt(0) == 0);
+        REQUIRE(BigInt::isqrt(BigInt("999999999999999999")) == 999999999);
+        REQUIRE(BigInt::isqrt(BigInt("1000000000000000000")) == 1000000000);
+        REQUIRE_THROWS(BigInt::isqrt(-4));
+    }
+
+    SUBCASE("iroot")
+    {
+        mt19937 gen(15);
+        for (int k : {3, 4, 7, 20, 101})
+        {
+            BigInt x = randomBigInt(gen, 700);
+            BigInt r = BigInt::iroot(x, k);
+            REQUIRE(BigInt::pow(r, k) <= x);
+            REQUIRE(BigInt::pow(r + 1, k) > x);
+        }
+
+        BigInt c = randomBigInt(gen, 100);
+        REQUIRE(BigInt::iroot(BigInt::pow(c, 5), 5) == c);
+        REQUIRE(BigInt::iroot(BigInt::pow(c, 5) - 1, 5) == c - 1);
+        REQUIRE(BigInt::iroot(-BigInt::pow(c, 3), 3) == -c);
+        REQUIRE(BigInt::iroot(12345, 1) == 12345);
+        REQUIRE(BigInt::iroot(2, 1000) == 1);
+        REQUIRE_THROWS(BigInt::iroot(-8, 2));
+        REQUIRE_THROWS(BigInt::iroot(8, 0));
+    }
+
+    SUBCASE("isPerfectPower")
+    {
+        BigInt base;
+        long long exponent = 0;
+
+        REQUIRE(BigInt::isPerfectPower(BigInt::pow(BigInt("123456789123"), 12), base, exponent));
+        REQUIRE(base == BigInt("123456789123"));
+        REQUIRE(exponent == 12);
+
+        REQUIRE(BigInt::isPerfectPower(BigInt::pow(2, 1000), base, exponent));
+        REQUIRE(base == 2);
+        REQUIRE(exponent == 1000);
+
+        REQUIRE(BigInt::isPerfectPower(-BigInt::pow(6, 15), base, exponent));
+        REQUIRE(base == -6);
+        REQUIRE(exponent == 15);
+
+        REQUIRE(BigInt::isPerfectPower(BigInt(-64), base, exponent));
+        REQUIRE(base == -4);
+        REQUIRE(exponent == 3);
+
+        REQUIRE_FALSE(BigInt::isPerfectPower(BigInt::pow(7, 30) + 1));
+        REQUIRE_FALSE(BigInt::isPerfectPower(BigInt("-16")));
+        REQUIRE_FALSE(BigInt::isPerfectPower(BigInt::factorial(300)));
+        REQUIRE(BigInt::isPerfectPower(1));
+    }
+}
+
+TEST_CASE("Parallel multiplication")
+{
+    mt19937 gen(16);
+    vector<pair<BigInt, BigInt>> operands;
+    for (int digits : {600, 5000, 20000, 60000})
+    {
+        operands.emplace_back(randomBigInt(gen, digits), randomBigInt(gen, digits));
+        operands.emplace_back(randomBigInt(gen, digits), randomBigInt(gen, digits / 7 + 1));
+    }
+
+    vector<BigInt> expected;
+    for (auto &p : operands)
+    {
+        expected.push_back(p.first * p.second);
+    }
+
+    for (unsigned threads : {2u, 3u, 8u})
+    {
+        BigInt::setParallelism(threads, 64);
+        REQUIRE(BigInt::parallelism() == threads);
+
+        for (size_t i = 0; i < operands.size(); i++)
+        {
+            REQUIRE(operands[i].first * operands[i].second == expected[i]);
+        }
+    }
+
+    BigInt::setParallelism(1);
+    REQUIRE(BigInt::parallelism() == 1);
+}
+
+TEST_CASE("Limb storage reuse")
+{
+    mt19937 gen(19);
+    BigInt a = randomBigInt(gen, 3000), b = randomBigInt(gen, 1500);
+
+    BigInt::releaseCachedLimbs();
+    BigInt::resetAllocationStats();
+
+    // q and r keep their blocks, so the first two runs fill the cache
+    BigInt q, r;
+    BigInt::divmod(a, b, q, r);
+    BigInt::divmod(a, b, q, r);
+    BigInt::AllocationStats first = BigInt::allocationStats();
+    REQUIRE(first.allocations >= first.heapAllocations);
+    REQUIRE(first.heapAllocations > 0);
+
+    // The same job again takes every block from the cache
+    for (int i = 0; i < 10; i++)
+    {
+        BigInt::divmod(a, b, q, r);
+    }
+    BigInt::AllocationStats later = BigInt::allocationStats();
+    REQUIRE(later.allocations > first.allocations);
+    REQUIRE(later.heapAllocations == first.heapAllocations);
+    REQUIRE(q * b + r == a);
+
+    // Values may die on another thread than the one that built them
+    vector<BigInt> made;
+    thread producer([&]
+                    {
+                        for (int i = 1; i <= 20; i++)
+                        {
+                            made.push_back(a * i);
+                        }
+                    });
+    producer.join();
+    for (int i = 0; i < 20; i++)
+    {
+        REQUIRE(made[i] == a * (i + 1));
+    }
+    made.clear();
+
+    BigInt::resetAllocationStats();
+    REQUIRE(BigInt::allocationStats().allocations == 0);
+    BigInt::releaseCachedLimbs();
+    REQUIRE(BigInt::allocationStats().heapFrees > 0);
+    REQUIRE(BigInt::allocationStats().heapAllocations == 0);
+}
+
+TEST_CASE("Binary serialization")
+{
+    SUBCASE("layout")
+    {
+        string s = BigInt("-1234567890123").serialize();
+        const unsigned char expected[] = {5, 0, 0, 0, 0, 0, 0, 0,
+                                          0xcb, 0x50, 0xd9, 0x21,
+                                          0xd2, 0x04, 0, 0};
+        REQUIRE(s == string(reinterpret_cast<const char *>(expected), sizeof(expected)));
+        REQUIRE(BigInt(0).serialize() == string(8, '\0'));
+    }
+
+    SUBCASE("round trip")
+    {
+        mt19937 gen(20);
+        vector<BigInt> values = {0, 1, -1, BigInt("999999999"), BigInt("-1000000000"),
+                                 randomBigInt(gen, 5000), -randomBigInt(gen, 40000)};
+
+        for (const BigInt &x : values)
+        {
+            string s = x.serialize();
+            REQUIRE(s.size() == x.serializedSize());
+            REQUIRE(BigInt::deserialize(s) == x);
+        }
+    }
+
+    SUBCASE("views over a sequence of values")
+    {
+        mt19937 gen(21);
+        vector<BigInt> values = {randomBigInt(gen, 100), 0, -randomBigInt(gen, 30), randomBigInt(gen, 3000)};
+
+        size_t total = 0;
+        for (const BigInt &x : values)
+        {
+            total += x.serializedSize();
+        }
+
+        vector<unsigned char> buffer(total);
+        unsigned char *out = buffer.data();
+        for (const BigInt &x : values)
+        {
+            out = x.serialize(out);
+        }
+        REQUIRE(out == buffer.data() + total);
+
+        size_t offset = 0;
+        for (const BigInt &x : values)
+        {
+            BigInt::View v(buffer.data() + offset, total - offset);
+            REQUIRE(v.isNegative() == (x < 0));
+            REQUIRE(v.compare(x) == 0);
+            REQUIRE(v.compare(x + 1) == -1);
+            REQUIRE(v.compare(x - 1) == 1);
+            REQUIRE(v.toBigInt() == x);
+            offset += v.byteSize();
+        }
+        REQUIRE(offset == total);
+
+        BigInt::View last(buffer.data() + total - values.back().serializedSize(), values.back().serializedSize());
+        REQUIRE(last.limbCount() == 334);
+        REQUIRE(last.limb(0) == values.back() % 1000000000);
+    }
+
+    SUBCASE("malformed input")
+    {
+        string s = BigInt("123456789012345678901234567890").serialize();
+
+        REQUIRE_THROWS_AS(BigInt::deserialize(s.substr(0, 7)), runtime_error);
+        REQUIRE_THROWS_AS(BigInt::deserialize(s.substr(0, s.size() - 1)), runtime_error);
+
+        string big = s;
+        big[8] = char(0xff), big[9] = char(0xff), big[10] = char(0xff), big[11] = char(0xff);
+        REQUIRE_THROWS_AS(BigInt::deserialize(big), runtime_error);
+
+        string padded = s;
+        padded[0] += 2;
+        padded += string(4, '\0');
+        REQUIRE_THROWS_AS(BigInt::deserialize(padded), runtime_error);
+
+        string negativeZero(8, '\0');
+        negativeZero[0] = 1;
+        REQUIRE_THROWS_AS(BigInt::deserialize(negativeZero), runtime_error);
+
+        string huge(8, char(0xff));
+        REQUIRE_THROWS_AS(BigInt::View(huge.data(), huge.size()), runtime_error);
+    }
+}